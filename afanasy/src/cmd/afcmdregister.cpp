@@ -58,6 +58,7 @@ void AfCmd::RegisterCommands()
 	addCmd( new CmdRenderEjectTasks);
 	addCmd( new CmdRenderEjectNotMyTasks);
 	addCmd( new CmdRenderExit);
+	addCmd( new CmdRenderReloadPython);
 	addCmd( new CmdRenderDelete);
 	addCmd( new CmdRenderResoucesList);
 	addCmd( new CmdRenderWOLSleep);
@@ -207,6 +207,22 @@ bool CmdRenderExit::v_processArguments( int argc, char** argv, af::Msg &msg)
 	return true;
 }
 
+CmdRenderReloadPython::CmdRenderReloadPython()
+{
+	setCmd("rreloadpy");
+	setInfo("Reload render python modules.");
+	setHelp("rreloadpy [name] Ask render to reload services and parsers python modules, in no name porivieded, local host name used.");
+	setMsgType( af::Msg::TJSON);
+}
+CmdRenderReloadPython::~CmdRenderReloadPython(){}
+bool CmdRenderReloadPython::v_processArguments( int argc, char** argv, af::Msg &msg)
+{
+	std::string name( af::Environment::getHostName());
+	if( argc > 0) name = argv[0];
+	af::jsonActionOperation( m_str, "renders", "reload_python", name);
+	return true;
+}
+
 CmdRenderDelete::CmdRenderDelete()
 {
 	setCmd("rdel");
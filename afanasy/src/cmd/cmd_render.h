@@ -54,6 +54,11 @@ class CmdRenderExit : public Cmd { public:
    ~CmdRenderExit();
    bool v_processArguments( int argc, char** argv, af::Msg &msg);
 };
+class CmdRenderReloadPython : public Cmd { public:
+   CmdRenderReloadPython();
+   ~CmdRenderReloadPython();
+   bool v_processArguments( int argc, char** argv, af::Msg &msg);
+};
 class CmdRenderDelete : public Cmd { public:
    CmdRenderDelete();
    ~CmdRenderDelete();
@@ -61,6 +61,7 @@ namespace AFSERVER
 	const bool SOLVING_SIMPLER           = false; ///< Sort jobs by priority and creation time instead of using the "Need"
 	const int  SOLVING_TASKS_SPEED       = -1;
 	const int  SOLVING_WAKE_PER_CYCLE    = 1;
+	const bool SOLVING_INCREMENTAL       = true;  ///< Keep solving nodes and renders sorted across a cycle instead of resorting per task
 
 	const int  SOCKETS_READWRITE_THREADS_NUM   = 10;
 	const int  SOCKETS_PROCESSING_THREADS_NUM  = 10;
@@ -68,7 +69,20 @@ namespace AFSERVER
 	const int  SOCKETS_PROCESSING_THREADS_STACK = 0;
 
 	const int  LINUX_EPOLL = 0;
+	const int  CONNECTION_KEEP_ALIVE_SEC = 30; ///< Idle persistent client connection is closed after this time, zero disables
 	const int  PROFILING_SEC = 1024;
+	const int  RESPONSE_CACHE_SIZE = 1000; ///< Maximum number of cached nodes lists responses, zero disables
+	const int  OUTPUT_COMPRESS_LEVEL = 0;  ///< Store tasks output gzip compressed with this level, zero disables
+
+	const int  RUN_CYCLE_MIN_MSEC = 100;  ///< Run cycle can't follow more often, even if woken by events
+	const int  RUN_CYCLE_MAX_MSEC = 1000; ///< Run cycle follows at least this often, to process timers
+
+	const bool STORE_TASKS_PROGRESS_LOG         = true; ///< Store job tasks progress in a single append-only log instead of a file per task
+	const int  STORE_TASKS_PROGRESS_LOG_COMPACT = 4;    ///< Rewrite log when it has more records than tasks number multiplied by this
+	const int  STORE_LOAD_THREADS               = 8;    ///< Number of threads to read stored jobs on start
+
+	const int  FILE_QUEUE_THREADS = 4;       ///< Number of threads to write files, each writes its own part of paths
+	const char TRASH_FOLDER[]     = "trash"; ///< Deleted nodes store folders are moved here before removal, relative to store folder
 }
 
 /// Database options:
@@ -79,6 +93,9 @@ namespace AFDATABASE
     const int  STRINGNAMELEN  = 512;       ///< Maximum name lenght (for job, user, render, block, task, service, parser etc...).
     const int  STRINGEXPRLEN  = 4096;      ///< Maximum lenght for expression (command, dependmask, hostsmask,view command etc...).
     const int  RECONNECTAFTER = 60;        ///< If connection lost, try to reconnect every RECONNECTAFTER seconds.
+    const int  BATCH_SIZE     = 1000;      ///< Maximum number of queued records written in one transaction.
+    const int  QUEUE_MAX      = 100000;    ///< Maximum number of queued records in memory, others are spilled to journal.
+    const char JOURNAL_FILE[] = "db_journal"; ///< Spilled records journal, relative to store folder.
 }
 
 /// Render options:
@@ -98,6 +115,11 @@ namespace AFRENDER
     const int  ZOMBIETIME               = 60;         ///< Seconds to wait for update to Render is zombie.
     const int  EXIT_NO_TASK_TIME        = -1;         ///< Seconds to exit if no tasks.
     const int  CONNECTRETRIES           = 3;          ///< Number of connect fails to turn to disconnected state.
+    const bool SERVER_CONNECTION_KEEP   = false;      ///< Keep a persistent connection to server.
+    const bool EVENTS_WAIT              = false;      ///< Wait for server events instead of sleeping between heartbeats.
+    const bool PARSERS_NATIVE           = false;      ///< Use compiled parsers instead of python ones with the same name.
+    const int  OUTPUT_COMPRESS_LEVEL    = 0;          ///< Send tasks output to server gzip compressed with this level, zero disables.
+    const int  OUTPUT_STREAM_BUDGET     = 0;          ///< Running tasks output bytes sent to server per heartbeat, zero disables.
     const int  MAXCOUNT                 = 100000;     ///< Maximum allowed online Renders.
     const int  TASKPROCESSNICE          = 10;         ///< Child process nice.
     const char STORE_FOLDER[]           = "renders";  ///< Renders store directory, relative to AFSERVER::TEMP_DIRECTORY
@@ -130,6 +152,7 @@ namespace AFMONITOR
 {
     const int MAXCOUNT   = 100000;   ///< Maximum allowed online Monitors.
     const int ZOMBIETIME = 40;       ///< Seconds to wait for update to consider to kill Monitor.
+    const int EVENTS_WAIT_SEC = 8;   ///< Seconds to hold monitor events request if there are no events.
 }
 
 /// Network options:
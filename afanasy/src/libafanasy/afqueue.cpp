@@ -121,6 +121,12 @@ void AfQueue::unlock()
    m_mutex.Unlock();
 }
 
+int AfQueue::getCount()
+{
+   DlScopeLocker lock( &m_mutex );
+   return count;
+}
+
 bool AfQueue::push( AfQueueItem* item, bool i_front )
 {
 
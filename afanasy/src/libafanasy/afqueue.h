@@ -59,6 +59,9 @@ public:
 
    bool isInitialized( void ) const { return true; }
 
+   /// Number of items in queue.
+   int getCount();
+
    // Will just increase semaphore count, with no item push.
    // It will cause waking pop() with a NULL item pointer.
    // Needed to wake up waiting threads to join them on application exit.
@@ -1,6 +1,7 @@
 
 #include "blockdata.h"
 
+#include <assert.h>
 #include <memory.h>
 #include <stdio.h>
 #include <string.h>
@@ -115,6 +116,8 @@ AFINFA("BlockData::BlockData(): JobId=%d, BlockNum=%d", m_job_id, m_block_num)
 void BlockData::construct()
 {
    m_tasks_num = 0;
+   m_solve_epoch = 1;
+   m_progress_percents_sum = 0;
    m_tasks_data = NULL;
    m_running_tasks_counter = 0;
    m_running_capacity_counter = 0;
@@ -932,14 +935,131 @@ void BlockData::setFramesPerTask( long long perTask)
    m_frames_per_task = perTask;
 }
 
+// Bits helpers for ready tasks index,
+// word should not be zero.
+static inline int lowestBit( uint64_t i_word)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll( i_word);
+#else
+	int bit = 0;
+	while(( i_word & 1 ) == 0 ) { i_word >>= 1; bit++; }
+	return bit;
+#endif
+}
+static inline int highestBit( uint64_t i_word)
+{
+#if defined(__GNUC__)
+	return 63 - __builtin_clzll( i_word);
+#else
+	int bit = 63;
+	while(( i_word & ( uint64_t(1) << 63 )) == 0 ) { i_word <<= 1; bit--; }
+	return bit;
+#endif
+}
+
+void BlockData::checkSolvingIndexes()
+{
+	// Indexes are allocated on the first solving and on tasks number change.
+	// A new ready hint means that each task can be ready.
+	int words = ( m_tasks_num + 63 ) / 64;
+	if( int( m_ready_hint.size()) != words )
+		m_ready_hint.assign( words, ~uint64_t(0));
+
+	if( int( m_tasks_solved_epoch.size()) != m_tasks_num )
+		m_tasks_solved_epoch.assign( m_tasks_num, 0);
+}
+
+void BlockData::startSolving()
+{
+	m_solve_epoch++;
+
+	// On epoch overflow markers should be reset,
+	// as old markers can be equal to a new epoch value.
+	if( m_solve_epoch == 0 )
+	{
+		m_tasks_solved_epoch.assign( m_tasks_solved_epoch.size(), 0);
+		m_solve_epoch = 1;
+	}
+}
+
+void BlockData::setTaskReadyHint( int i_task, bool i_ready)
+{
+	if(( i_task < 0 ) || ( i_task >= m_tasks_num ))
+		return;
+
+	checkSolvingIndexes();
+
+	if( i_ready )
+		m_ready_hint[i_task >> 6] |= uint64_t(1) << ( i_task & 63 );
+	else
+		m_ready_hint[i_task >> 6] &= ~( uint64_t(1) << ( i_task & 63 ));
+}
+
+int BlockData::nextReadyHint( int i_task) const
+{
+	if( i_task < 0 )
+		i_task = 0;
+
+	int w = i_task >> 6;
+	if( w >= int( m_ready_hint.size()))
+		return m_tasks_num;
+
+	// Skip bits below the task in the first word:
+	uint64_t word = m_ready_hint[w] & ( ~uint64_t(0) << ( i_task & 63 ));
+	while( word == 0 )
+	{
+		if( ++w >= int( m_ready_hint.size()))
+			return m_tasks_num;
+		word = m_ready_hint[w];
+	}
+
+	int task = ( w << 6 ) + lowestBit( word);
+	return task < m_tasks_num ? task : m_tasks_num;
+}
+
+int BlockData::prevReadyHint( int i_task) const
+{
+	if( i_task >= m_tasks_num )
+		i_task = m_tasks_num - 1;
+	if( i_task < 0 )
+		return -1;
+
+	int w = i_task >> 6;
+
+	// Skip bits above the task in the first word:
+	uint64_t word = m_ready_hint[w] & ( ~uint64_t(0) >> ( 63 - ( i_task & 63 )));
+	while( word == 0 )
+	{
+		if( --w < 0 )
+			return -1;
+		word = m_ready_hint[w];
+	}
+
+	return ( w << 6 ) + highestBit( word);
+}
+
+bool BlockData::checkTaskReady( TaskProgress ** i_tp, int i_task)
+{
+	if( i_tp[i_task]->state & AFJOB::STATE_READY_MASK )
+		return true;
+
+	// Task is not ready, so there is no need to check it again,
+	// till some its state change will set the hint back:
+	m_ready_hint[i_task >> 6] &= ~( uint64_t(1) << ( i_task & 63 ));
+	return false;
+}
+
 int BlockData::getReadyTaskNumber( TaskProgress ** i_tp, const int64_t & i_job_flags, const Render * i_render)
 {
 	//printf("af::getReadyTaskNumber: %li-%li/%li:%li%%%li\n", m_frame_first, m_frame_last, m_frames_inc, m_frames_per_task, m_sequential);
+	checkSolvingIndexes();
+
 	if( i_render && ( i_job_flags & Job::FMaintenance ))
 	{
-		for( int task = 0; task < m_tasks_num; task++)
+		for( int task = nextReadyHint( 0); task < m_tasks_num; task = nextReadyHint( task + 1))
 		{
-			if( i_tp[task]->state & AFJOB::STATE_READY_MASK )
+			if( checkTaskReady( i_tp, task))
 			{
 				if( genTaskName( task) == i_render->getName())
 					return task;
@@ -982,26 +1102,24 @@ int BlockData::getReadyTaskNumber( TaskProgress ** i_tp, const int64_t & i_job_f
 				break;
 			}
 
-			if( i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
+			if( isTaskSolved( task)) continue;
+			setTaskSolved( task);
 
-			if( i_tp[task]->state & AFJOB::STATE_READY_MASK )
+			if( isTaskReadyHint( task) && checkTaskReady( i_tp, task))
 				return task;
 		}
 
 		if( i_job_flags & af::Job::FPPApproval )
 			return AFJOB::TASK_NUM_NO_SEQUENTIAL;
 
-		for( int task = 0; task < m_tasks_num; task++)
+		// Common tasks solving:
+		for( int task = nextReadyHint( 0); task < m_tasks_num; task = nextReadyHint( task + 1))
 		{
-			// Common tasks solving:
-			if( i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
+			if( isTaskSolved( task)) continue;
+			setTaskSolved( task);
 
-			if( i_tp[task]->state & AFJOB::STATE_READY_MASK )
+			if( checkTaskReady( i_tp, task))
 				return task;
-
-			continue;
 		}
 
 		return AFJOB::TASK_NUM_NO_TASK;
@@ -1024,84 +1142,96 @@ int BlockData::getReadyTaskNumber( TaskProgress ** i_tp, const int64_t & i_job_f
 				break;
 			}
 
-			if( i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
+			if( isTaskSolved( task)) continue;
+			setTaskSolved( task);
 
-			if( i_tp[task]->state & AFJOB::STATE_READY_MASK )
+			if( isTaskReadyHint( task) && checkTaskReady( i_tp, task))
 				return task;
 		}
 
-		for( int task = m_tasks_num-1; task >= 0; task--)
+		// Common tasks solving:
+		for( int task = prevReadyHint( m_tasks_num - 1); task >= 0; task = prevReadyHint( task - 1))
 		{
-			// Common tasks solving:
-			if( i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
+			if( isTaskSolved( task)) continue;
+			setTaskSolved( task);
 
-			if( i_tp[task]->state & AFJOB::STATE_READY_MASK )
+			if( checkTaskReady( i_tp, task))
 				return task;
-
-			continue;
 		}
 
 		return AFJOB::TASK_NUM_NO_TASK;
 	}
 
-	for( int task = 0; task < m_tasks_num; task++)
+	if( isSequential())
 	{
-		if( isSequential())
+		// Common tasks solving:
+		for( int task = nextReadyHint( 0); task < m_tasks_num; task = nextReadyHint( task + 1))
 		{
-			// Common tasks solving:
-			if( i_tp[task]->isSolved()) continue;
-			i_tp[task]->setSolved();
+			if( isTaskSolved( task)) continue;
+			setTaskSolved( task);
 
-			if( i_tp[task]->state & AFJOB::STATE_READY_MASK )
+			if( checkTaskReady( i_tp, task))
 				return task;
-
-			continue;
 		}
 
-		if( m_sequential == -1 )
+		return AFJOB::TASK_NUM_NO_TASK;
+	}
+
+	if( m_sequential == -1 )
+	{
+		// Reverse tasks solving:
+		for( int task = prevReadyHint( m_tasks_num - 1); task >= 0; task = prevReadyHint( task - 1))
 		{
-			// Reverse tasks solving:
-			int index = m_tasks_num - 1 - task;
+			if( isTaskSolved( task)) continue;
+			setTaskSolved( task);
 
-			if( i_tp[index]->isSolved()) continue;
-			i_tp[index]->setSolved();
+			if( checkTaskReady( i_tp, task))
+				return task;
+		}
 
-			if( i_tp[index]->state & AFJOB::STATE_READY_MASK )
-				return index;
+		return AFJOB::TASK_NUM_NO_TASK;
+	}
 
-			continue;
-		}
+	// Middle task solving:
+	// Tasks are taken by dividing block in 1, 2, 4, 8, ... parts,
+	// till the power of two that is not less than the last task number.
+	// When parts number reaches tasks number, each task is taken.
+	if( nextReadyHint( 0) >= m_tasks_num )
+		return AFJOB::TASK_NUM_NO_TASK;
 
-		// Middle task solving:
-		int64_t powered = 1;
-		while( powered < task )
-			powered <<= 1;
+	int64_t powered_max = 1;
+	while( powered_max < m_tasks_num - 1 )
+		powered_max <<= 1;
 
+	for( int64_t powered = 1; ; powered <<= 1 )
+	{
 		bool nodivision_needed = false;
+		int64_t parts = powered;
 		if( powered >= m_tasks_num )
 		{
 			nodivision_needed = true;
-			powered = m_tasks_num;
+			parts = m_tasks_num;
 		}
 
-		//printf(" task=%d, powered=%lld\n", task, powered);
-		for( int64_t i = 0; i <= powered; i++)
+		//printf(" parts=%lld\n", parts);
+		for( int64_t i = 0; i <= parts; i++)
 		{
 			int index = i;
 			if( false == nodivision_needed )
-				index = int( i * int64_t(m_tasks_num) / powered );
+				index = int( i * int64_t(m_tasks_num) / parts );
 
 			if( index >= m_tasks_num )
 				index = m_tasks_num - 1;
 
-			if( i_tp[index]->isSolved()) continue;
-			i_tp[index]->setSolved();
+			if( isTaskSolved( index)) continue;
+			setTaskSolved( index);
 
-			if( i_tp[index]->state & AFJOB::STATE_READY_MASK )
+			if( isTaskReadyHint( index) && checkTaskReady( i_tp, index))
 				return index;
 		}
+
+		if( nodivision_needed || ( powered >= powered_max ))
+			break;
 	}
 
 	// No ready tasks found:
@@ -1451,114 +1581,272 @@ void BlockData::v_generateInfoStream( std::ostringstream & o_str, bool full) con
 // (for monitoring purpoces only, no meaning for server)
 bool BlockData::updateProgress( JobProgress * progress)
 {
-   bool changed = false;
-
-	updateBars( progress);
-
-	// Just store depend state, all other flags will be calculated
-	m_state = m_state & AFJOB::STATE_WAITDEP_MASK;
-
-	int32_t   new_percentage     = 0;
-	int32_t   new_tasks_ready    = 0;
-	int32_t   new_tasks_done     = 0;
-	int32_t   new_tasks_error    = 0;
-	int       new_tasks_skipped  = 0;
-	int       new_tasks_warning  = 0;
-	int       new_tasks_waitrec  = 0;
-	long long new_tasks_run_time = 0;
-
-
-   for( int t = 0; t < m_tasks_num; t++)
-   {
-      uint32_t task_state   = progress->tp[m_block_num][t]->state;
-      int8_t   task_percent = 0;
+	const TaskProgress * tasks = progress->getTasksProgress( m_block_num);
+
+	int32_t   old_percentage     = p_percentage;
+	int32_t   old_tasks_ready    = p_tasks_ready;
+	int32_t   old_tasks_done     = p_tasks_done;
+	int32_t   old_tasks_error    = p_tasks_error;
+	int       old_tasks_skipped  = p_tasks_skipped;
+	int       old_tasks_warning  = p_tasks_warning;
+	int       old_tasks_waitrec  = p_tasks_waitrec;
+	long long old_tasks_run_time = p_tasks_run_time;
+
+	if( int( m_progress_states.size()) != m_tasks_num )
+	{
+		progressUpdateAll( tasks);
+	}
+	else
+	{
+		// Bar symbols that changed tasks cover:
+		bool bar_changed[AFJOB::ASCII_PROGRESS_LENGTH] = {false};
+		bool bar_has_changes = false;
 
-      if( task_state & AFJOB::STATE_READY_MASK   )
-      {
-         new_tasks_ready++;
-      }
-      if( task_state & AFJOB::STATE_DONE_MASK    )
-      {
-         new_tasks_done++;
-         task_percent = 100;
-         new_tasks_run_time += progress->tp[m_block_num][t]->time_done - progress->tp[m_block_num][t]->time_start;
-      }
-      if( task_state & AFJOB::STATE_RUNNING_MASK )
-      {
-         task_percent = progress->tp[m_block_num][t]->percent;
-         if( task_percent <  0 ) task_percent = 0;
-         else
-         if( task_percent > 99 ) task_percent = 99;
-      }
-      if( task_state & AFJOB::STATE_ERROR_MASK   )
-      {
-         new_tasks_error++;
-         task_percent = 0;
-         new_tasks_run_time += progress->tp[m_block_num][t]->time_done - progress->tp[m_block_num][t]->time_start;
-      }
-		if( task_state & AFJOB::STATE_SKIPPED_MASK )
-		{
-			new_tasks_skipped++;
-			task_percent = 100;
-		}
-		if( task_state & AFJOB::STATE_WARNING_MASK )
-		{
-			new_tasks_warning++;
-		}
-		if( task_state & AFJOB::STATE_WAITRECONNECT_MASK )
+		for( std::vector<int>::const_iterator it = m_progress_changed.begin(); it != m_progress_changed.end(); it++)
 		{
-			new_tasks_waitrec++;
+			int t = *it;
+			m_progress_changed_flags[t] = false;
+
+			int old_value = progressBarValue( m_progress_states[t]);
+			progressUpdateTask( tasks[t], t);
+			if( old_value == progressBarValue( m_progress_states[t]))
+				continue;
+
+			int pos_a, pos_b;
+			progressBarRange( t, pos_a, pos_b);
+			for( int p = pos_a; p <= pos_b; p++)
+				bar_changed[p] = true;
+			bar_has_changes = true;
 		}
+		m_progress_changed.clear();
 
-      new_percentage += task_percent;
-   }
-   new_percentage = new_percentage / m_tasks_num;
-
-	if(( p_tasks_ready    != new_tasks_ready    )||
-	   ( p_tasks_done     != new_tasks_done     )||
-	   ( p_tasks_error    != new_tasks_error    )||
-	   ( p_tasks_skipped  != new_tasks_skipped  )||
-	   ( p_tasks_warning  != new_tasks_warning  )||
-	   ( p_tasks_waitrec  != new_tasks_waitrec  )||
-	   ( p_percentage     != new_percentage     )||
-	   ( p_tasks_run_time != new_tasks_run_time ))
+		if( bar_has_changes )
+			for( int p = 0; p < AFJOB::ASCII_PROGRESS_LENGTH; p++)
+				if( bar_changed[p] )
+					progressUpdateBar( p);
+
+#ifdef _DEBUG
+		progressCheck( tasks);
+#endif
+	}
+
+	p_percentage = m_progress_percents_sum / m_tasks_num;
+
+	bool changed = false;
+	if(( p_tasks_ready    != old_tasks_ready    )||
+	   ( p_tasks_done     != old_tasks_done     )||
+	   ( p_tasks_error    != old_tasks_error    )||
+	   ( p_tasks_skipped  != old_tasks_skipped  )||
+	   ( p_tasks_warning  != old_tasks_warning  )||
+	   ( p_tasks_waitrec  != old_tasks_waitrec  )||
+	   ( p_percentage     != old_percentage     )||
+	   ( p_tasks_run_time != old_tasks_run_time ))
 		changed = true;
 
-	p_tasks_ready    = new_tasks_ready;
-	p_tasks_done     = new_tasks_done;
-	p_tasks_error    = new_tasks_error;
-	p_tasks_skipped  = new_tasks_skipped;
-	p_tasks_warning  = new_tasks_warning;
-	p_tasks_waitrec  = new_tasks_waitrec;
-	p_percentage     = new_percentage;
-	p_tasks_run_time = new_tasks_run_time;
+	// Just store depend state, all other flags will be calculated
+	m_state = m_state & AFJOB::STATE_WAITDEP_MASK;
 
-	if( new_tasks_ready && ( false == (m_state & AFJOB::STATE_WAITDEP_MASK)))
+	if( p_tasks_ready && ( false == (m_state & AFJOB::STATE_WAITDEP_MASK)))
 		m_state = m_state | AFJOB::STATE_READY_MASK;
 
 	if( m_running_tasks_counter )
 		m_state = m_state | AFJOB::STATE_RUNNING_MASK;
 
-	if( new_tasks_done == m_tasks_num )
+	if( p_tasks_done == m_tasks_num )
 	{
 		if (m_time_done == 0)
 			m_time_done = time(NULL);
 		m_state = m_state | AFJOB::STATE_DONE_MASK;
 	}
 
-	if( new_tasks_warning )
+	if( p_tasks_warning )
 		m_state = m_state | AFJOB::STATE_WARNING_MASK;
 
-	if( new_tasks_error )
+	if( p_tasks_error )
 		m_state = m_state | AFJOB::STATE_ERROR_MASK;
 
-	if( new_tasks_skipped )
+	if( p_tasks_skipped )
 		m_state = m_state | AFJOB::STATE_SKIPPED_MASK;
 
-   return changed;
+	return changed;
+}
+
+void BlockData::progressUpdateAll( const TaskProgress * i_tasks)
+{
+	// Full update: stored values are zeroed and all tasks are accounted.
+	m_progress_states.assign( m_tasks_num, 0);
+	m_progress_percents.assign( m_tasks_num, 0);
+	m_progress_run_times.assign( m_tasks_num, 0);
+	m_progress_percents_sum = 0;
+	m_progress_changed.clear();
+	m_progress_changed_flags.assign( m_tasks_num, false);
+
+	p_tasks_ready    = 0;
+	p_tasks_done     = 0;
+	p_tasks_error    = 0;
+	p_tasks_skipped  = 0;
+	p_tasks_warning  = 0;
+	p_tasks_waitrec  = 0;
+	p_tasks_run_time = 0;
+
+	for( int t = 0; t < m_tasks_num; t++)
+		progressUpdateTask( i_tasks[t], t);
+
+	updateBars();
+}
+
+void BlockData::progressCheck( const TaskProgress * i_tasks)
+{
+	int32_t   tasks_ready    = p_tasks_ready;
+	int32_t   tasks_done     = p_tasks_done;
+	int32_t   tasks_error    = p_tasks_error;
+	int       tasks_skipped  = p_tasks_skipped;
+	int       tasks_warning  = p_tasks_warning;
+	int       tasks_waitrec  = p_tasks_waitrec;
+	long long tasks_run_time = p_tasks_run_time;
+	int64_t   percents_sum   = m_progress_percents_sum;
+	char      progressbar[AFJOB::ASCII_PROGRESS_LENGTH];
+	memcpy( progressbar, p_progressbar, AFJOB::ASCII_PROGRESS_LENGTH);
+
+	progressUpdateAll( i_tasks);
+
+	if(( tasks_ready    == p_tasks_ready    ) &&
+	   ( tasks_done     == p_tasks_done     ) &&
+	   ( tasks_error    == p_tasks_error    ) &&
+	   ( tasks_skipped  == p_tasks_skipped  ) &&
+	   ( tasks_warning  == p_tasks_warning  ) &&
+	   ( tasks_waitrec  == p_tasks_waitrec  ) &&
+	   ( tasks_run_time == p_tasks_run_time ) &&
+	   ( percents_sum   == m_progress_percents_sum ) &&
+	   ( memcmp( progressbar, p_progressbar, AFJOB::ASCII_PROGRESS_LENGTH) == 0 ))
+		return;
+
+	AF_ERR << "Block[" << m_name << "] of job " << m_job_id << ": incremental progress differs from a full update:"
+		<< " ready " << tasks_ready << "/" << p_tasks_ready
+		<< ", done " << tasks_done << "/" << p_tasks_done
+		<< ", error " << tasks_error << "/" << p_tasks_error
+		<< ", percents " << percents_sum << "/" << m_progress_percents_sum;
+
+	assert( !"Block incremental progress differs from a full update." );
+}
+
+void BlockData::setTaskProgressChanged( int i_task)
+{
+	if(( i_task < 0 ) || ( i_task >= m_tasks_num ))
+		return;
+
+	setTaskReadyHint( i_task);
+
+	// Not updated yet, next update will be the full one.
+	if( int( m_progress_changed_flags.size()) != m_tasks_num )
+		return;
+
+	if( m_progress_changed_flags[i_task] )
+		return;
+
+	m_progress_changed_flags[i_task] = true;
+	m_progress_changed.push_back( i_task);
+}
+
+void BlockData::progressAccountTask( int i_task, int i_sign)
+{
+	uint32_t task_state = m_progress_states[i_task];
+
+	if( task_state & AFJOB::STATE_READY_MASK         ) p_tasks_ready   += i_sign;
+	if( task_state & AFJOB::STATE_DONE_MASK          ) p_tasks_done    += i_sign;
+	if( task_state & AFJOB::STATE_ERROR_MASK         ) p_tasks_error   += i_sign;
+	if( task_state & AFJOB::STATE_SKIPPED_MASK       ) p_tasks_skipped += i_sign;
+	if( task_state & AFJOB::STATE_WARNING_MASK       ) p_tasks_warning += i_sign;
+	if( task_state & AFJOB::STATE_WAITRECONNECT_MASK ) p_tasks_waitrec += i_sign;
+
+	m_progress_percents_sum += i_sign * m_progress_percents[i_task];
+	p_tasks_run_time        += i_sign * m_progress_run_times[i_task];
+}
+
+void BlockData::progressUpdateTask( const TaskProgress & i_tp, int i_task)
+{
+	progressAccountTask( i_task, -1);
+
+	uint32_t task_state   = i_tp.state;
+	int8_t   task_percent = 0;
+	int64_t  task_run_time = 0;
+
+	if( task_state & AFJOB::STATE_DONE_MASK    )
+	{
+		task_percent = 100;
+		task_run_time += i_tp.time_done - i_tp.time_start;
+	}
+	if( task_state & AFJOB::STATE_RUNNING_MASK )
+	{
+		task_percent = i_tp.percent;
+		if( task_percent <  0 ) task_percent = 0;
+		else
+		if( task_percent > 99 ) task_percent = 99;
+	}
+	if( task_state & AFJOB::STATE_ERROR_MASK   )
+	{
+		task_percent = 0;
+		task_run_time += i_tp.time_done - i_tp.time_start;
+	}
+	if( task_state & AFJOB::STATE_SKIPPED_MASK )
+		task_percent = 100;
+
+	m_progress_states[i_task]    = task_state;
+	m_progress_percents[i_task]  = task_percent;
+	m_progress_run_times[i_task] = task_run_time;
+
+	progressAccountTask( i_task, 1);
+
+	setTaskReadyHint( i_task, task_state & AFJOB::STATE_READY_MASK);
+}
+
+int BlockData::progressBarValue( uint32_t i_state)
+{
+	// Get maximum ASCII state for this task:
+	int value = 0;
+	for( int i = 0; i < AFJOB::ASCII_PROGRESS_COUNT; i++)
+		if(( i_state & AFJOB::ASCII_PROGRESS_MASK ) == AFJOB::ASCII_PROGRESS_STATES[i*2+1] )
+			if( value < i) // More important for monitoring value
+				value = i;
+	return value;
+}
+
+void BlockData::progressBarRange( int i_task, int & o_pos_a, int & o_pos_b) const
+{
+	o_pos_a = (long long)( AFJOB::ASCII_PROGRESS_LENGTH ) * ( i_task   ) / m_tasks_num;
+	o_pos_b = (long long)( AFJOB::ASCII_PROGRESS_LENGTH ) * ( i_task+1 ) / m_tasks_num;
+	if( o_pos_b > o_pos_a )
+		o_pos_b--;
+	if( o_pos_b > AFJOB::ASCII_PROGRESS_LENGTH )
+		o_pos_b = AFJOB::ASCII_PROGRESS_LENGTH - 1;
+}
+
+void BlockData::progressUpdateBar( int i_pos)
+{
+	// The first task that can cover this position:
+	int t = int( (long long)( i_pos ) * m_tasks_num / AFJOB::ASCII_PROGRESS_LENGTH ) - 1;
+	if( t < 0 )
+		t = 0;
+
+	int value = 0;
+	for( ; t < m_tasks_num; t++)
+	{
+		int pos_a, pos_b;
+		progressBarRange( t, pos_a, pos_b);
+		if( pos_a > i_pos )
+			break;
+		if( pos_b < i_pos )
+			continue;
+
+		int task_value = progressBarValue( m_progress_states[t]);
+		if( value < task_value )
+			value = task_value;
+	}
+
+	p_progressbar[i_pos] = AFJOB::ASCII_PROGRESS_STATES[value*2];
 }
 
-void BlockData::updateBars( JobProgress * progress)
+void BlockData::updateBars()
 {
 	// Set to zeros:
 	for( int i = 0; i < AFJOB::ASCII_PROGRESS_LENGTH; i++)
@@ -1566,20 +1854,11 @@ void BlockData::updateBars( JobProgress * progress)
 
 	for( int t = 0; t < m_tasks_num; t++)
 	{
-		// Get maximum ASCII state for this task:
-		int value = 0;
-		for( int i = 0; i < AFJOB::ASCII_PROGRESS_COUNT; i++)
-			if(( progress->tp[m_block_num][t]->state & AFJOB::ASCII_PROGRESS_MASK ) == AFJOB::ASCII_PROGRESS_STATES[i*2+1] )
-				if( value < i) // More important for monitoring value
-					value = i;
+		int value = progressBarValue( m_progress_states[t]);
 
 		// Calculate range:
-		int pos_a = AFJOB::ASCII_PROGRESS_LENGTH * ( t   ) / m_tasks_num;
-		int pos_b = AFJOB::ASCII_PROGRESS_LENGTH * ( t+1 ) / m_tasks_num;
-		if( pos_b > pos_a )
-			pos_b--;
-		if( pos_b > AFJOB::ASCII_PROGRESS_LENGTH )
-			pos_b = AFJOB::ASCII_PROGRESS_LENGTH - 1;
+		int pos_a, pos_b;
+		progressBarRange( t, pos_a, pos_b);
 
 		for( int p = pos_a; p <= pos_b; p++)
 		{
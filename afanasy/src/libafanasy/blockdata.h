@@ -71,6 +71,14 @@ public:
 	bool genNumbers(  long long & start, long long & end, int num, long long * frames_num = NULL ) const; ///< Generate fisrt and last frame numbers for \c num task.
 	int calcTaskNumber( long long i_frame, bool & o_valid_range) const;
 	int getReadyTaskNumber( TaskProgress ** i_tp, const int64_t & i_job_flags, const Render * i_render);
+
+	/// Start a new solving, tasks solved marks of the previous solving are discarded.
+	void startSolving();
+
+	/// Tell that task can be ready now, so solving should check it.
+	/** Ready tasks index is a hint: it can have not ready tasks, they are removed on solving,
+	*** but should have all ready tasks, so each task that becomes ready should be set. **/
+	void setTaskReadyHint( int i_task, bool i_ready = true);
 	const std::string genTaskName( int num, long long * fstart = NULL, long long * fend = NULL ) const;
 	const std::string genCommand(  int num, long long * fstart = NULL, long long * fend = NULL ) const;
 	const std::vector<std::string> genFiles(int num, long long * fstart = NULL, long long * fend = NULL ) const;
@@ -195,6 +203,11 @@ public:
 	inline bool checkHostsMaskExclude(  const std::string & str) const { return m_hosts_mask_exclude.match( str ); }
 	inline bool checkNeedProperties(    const std::string & str) const { return m_need_properties.match( str );   }
 
+	/// Cached checks, \c cache is a render cache of the \c str matches.
+	inline bool checkHostsMask(         const std::string & str, RegExpCache & cache) const { return m_hosts_mask.match( str, cache );         }
+	inline bool checkHostsMaskExclude(  const std::string & str, RegExpCache & cache) const { return m_hosts_mask_exclude.match( str, cache ); }
+	inline bool checkNeedProperties(    const std::string & str, RegExpCache & cache) const { return m_need_properties.match( str, cache );   }
+
 	inline int getCapacity()          const { return  m_capacity;        }
 	inline int getNeedMemory()        const { return  m_need_memory;     }
 	inline int getNeedPower()         const { return  m_need_power;      }
@@ -245,7 +258,15 @@ public:
 	inline int64_t * getRunningCapacityCounter()      { return &m_running_capacity_counter;}
 	inline int64_t   getRunningCapacityTotal()  const { return  m_running_capacity_counter;}
 
+	/// Update block progress counters and bar from tasks changed since the previous update.
+	/** The first update (and an update after tasks number change) scans all tasks.
+	*** Incremental updates are checked by a full one periodically (each update in debug build). **/
 	bool updateProgress( JobProgress * progress);
+
+	/// Tell that task progress was changed, next progress update should account it.
+	/** Changed task can become ready, so it is set in ready hint too. **/
+	void setTaskProgressChanged( int i_task);
+
 	inline const char * getProgressBar()          const { return p_progressbar;    }
 	inline int       getProgressPercentage()      const { return p_percentage;     }
 	inline int       getProgressErrorHostsNum()   const { return p_error_hosts;    }
@@ -385,15 +406,43 @@ private:
 	bool setMultiHost( int i_min, int i_max, int i_waitmax,
 			const std::string & i_service, int i_waitsrv);
 
+// Solving indexes:
+	void checkSolvingIndexes();
+	int  nextReadyHint( int i_task) const; ///< First hinted task not less than \c i_task, tasks number if none.
+	int  prevReadyHint( int i_task) const; ///< Last hinted task not greater than \c i_task, -1 if none.
+	inline bool isTaskReadyHint( int i_task) const { return m_ready_hint[i_task >> 6] & ( uint64_t(1) << ( i_task & 63 )); }
+	bool checkTaskReady( TaskProgress ** i_tp, int i_task);
+	inline bool isTaskSolved(  int i_task) const { return m_tasks_solved_epoch[i_task] == m_solve_epoch; }
+	inline void setTaskSolved( int i_task)       { m_tasks_solved_epoch[i_task] = m_solve_epoch; }
+
 // Functions to update tasks progress and progeress bar:
 // (for information purpoces only, no meaning for server)
-	void updateBars( JobProgress * progress);
+	void updateBars(); ///< Recalculate progress bar from stored tasks states.
+	void progressUpdateAll( const TaskProgress * i_tasks); ///< Zero stored values and account all tasks.
+	void progressCheck( const TaskProgress * i_tasks); ///< Full update, that should not change incremental counters (debug build check).
+	void progressAccountTask( int i_task, int i_sign); ///< Add or subtract stored task values from block counters.
+	void progressUpdateTask( const TaskProgress & i_tp, int i_task);
+	void progressUpdateBar( int i_pos); ///< Recalculate one progress bar symbol from stored tasks states.
+	void progressBarRange( int i_task, int & o_pos_a, int & o_pos_b) const;
+	static int progressBarValue( uint32_t i_state);
 /// Set one exact \c pos bit in \c array to \c value .
 	static void setProgressBit( uint8_t *array, int pos, bool value);
 /// Set progress bits in \c array with \c size at \c pos to \c value .
 	void setProgress( uint8_t *array, int task, bool value);
 
 private:
+	std::vector<uint64_t> m_ready_hint;          ///< Bit per task, that can be ready.
+	std::vector<uint32_t> m_tasks_solved_epoch;  ///< Solving epoch when task was tried.
+	uint32_t m_solve_epoch;                      ///< Current solving epoch.
+
+	// Tasks values that are summed in block progress counters:
+	std::vector<uint32_t> m_progress_states;
+	std::vector<int8_t>   m_progress_percents;
+	std::vector<int64_t>  m_progress_run_times;
+	int64_t               m_progress_percents_sum;
+	std::vector<int>      m_progress_changed;       ///< Tasks changed since the last progress update.
+	std::vector<bool>     m_progress_changed_flags;
+
 	char    p_progressbar[AFJOB::ASCII_PROGRESS_LENGTH];
 	uint8_t p_percentage;      ///< Tasks average percentage.
 	int32_t p_error_hosts;     ///< Number of error host of the block.
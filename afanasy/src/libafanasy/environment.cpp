@@ -47,10 +47,12 @@ bool    Environment::solving_use_user_priority =       AFSERVER::SOLVING_USE_USE
 bool    Environment::solving_simpler =                 AFSERVER::SOLVING_SIMPLER;
 int     Environment::solving_tasks_speed =             AFSERVER::SOLVING_TASKS_SPEED;
 int     Environment::solving_wake_per_cycle =          AFSERVER::SOLVING_WAKE_PER_CYCLE;
+bool    Environment::solving_incremental =             AFSERVER::SOLVING_INCREMENTAL;
 
 int     Environment::serverport =                      AFADDR::SERVER_PORT;
 
 int     Environment::monitor_zombietime =              AFMONITOR::ZOMBIETIME;
+int     Environment::monitor_events_wait_sec =         AFMONITOR::EVENTS_WAIT_SEC;
 
 int     Environment::watch_get_events_sec =            AFWATCH::GET_EVENTS_SEC;
 int     Environment::watch_connectretries =            AFWATCH::CONNECTRETRIES;
@@ -65,6 +67,11 @@ int     Environment::render_nice =                     AFRENDER::TASKPROCESSNICE
 int     Environment::render_zombietime =               AFRENDER::ZOMBIETIME;
 int     Environment::render_exit_no_task_time =        AFRENDER::EXIT_NO_TASK_TIME;
 int     Environment::render_connectretries =           AFRENDER::CONNECTRETRIES;
+bool    Environment::render_server_connection_keep =   AFRENDER::SERVER_CONNECTION_KEEP;
+bool    Environment::render_events_wait =              AFRENDER::EVENTS_WAIT;
+bool    Environment::render_parsers_native =           AFRENDER::PARSERS_NATIVE;
+int     Environment::render_output_compress_level =    AFRENDER::OUTPUT_COMPRESS_LEVEL;
+int     Environment::render_output_stream_budget =     AFRENDER::OUTPUT_STREAM_BUDGET;
 
 
 std::string Environment::rules_url;
@@ -102,7 +109,16 @@ int Environment::server_sockets_processing_threads_num   = AFSERVER::SOCKETS_PRO
 int Environment::server_sockets_processing_threads_stack = AFSERVER::SOCKETS_PROCESSING_THREADS_STACK;
 
 int Environment::server_linux_epoll                      = AFSERVER::LINUX_EPOLL;
+int Environment::server_connection_keep_alive_sec        = AFSERVER::CONNECTION_KEEP_ALIVE_SEC;
 int Environment::server_profiling_sec                    = AFSERVER::PROFILING_SEC;
+int Environment::server_response_cache_size              = AFSERVER::RESPONSE_CACHE_SIZE;
+int Environment::server_output_compress_level            = AFSERVER::OUTPUT_COMPRESS_LEVEL;
+int Environment::server_run_cycle_min_msec               = AFSERVER::RUN_CYCLE_MIN_MSEC;
+int Environment::server_run_cycle_max_msec               = AFSERVER::RUN_CYCLE_MAX_MSEC;
+bool Environment::server_store_tasks_progress_log        = AFSERVER::STORE_TASKS_PROGRESS_LOG;
+int Environment::server_store_tasks_progress_log_compact = AFSERVER::STORE_TASKS_PROGRESS_LOG_COMPACT;
+int Environment::server_store_load_threads               = AFSERVER::STORE_LOAD_THREADS;
+int Environment::server_file_queue_threads               = AFSERVER::FILE_QUEUE_THREADS;
 
 /// Socket Options:
 int Environment::so_server_LINGER       = AFNETWORK::SO_SERVER_LINGER;
@@ -129,6 +145,8 @@ std::string Environment::db_conninfo =                     AFDATABASE::CONNINFO;
 std::string Environment::db_stringquotes =                 AFDATABASE::STRINGQUOTES;
 int Environment::db_stringnamelen =                AFDATABASE::STRINGNAMELEN;
 int Environment::db_stringexprlen =                AFDATABASE::STRINGEXPRLEN;
+int Environment::db_batch_size =                   AFDATABASE::BATCH_SIZE;
+int Environment::db_queue_max =                    AFDATABASE::QUEUE_MAX;
 
 std::string Environment::store_folder = AFGENERAL::STORE_FOLDER;
 std::string Environment::store_folder_jobs;
@@ -221,6 +239,8 @@ void Environment::getVars( const JSON * i_obj)
 	getVar( i_obj, db_stringquotes,                   "af_db_stringquotes"                   );
 	getVar( i_obj, db_stringnamelen,                  "af_db_stringnamelen"                  );
 	getVar( i_obj, db_stringexprlen,                  "af_db_stringexprlen"                  );
+	getVar( i_obj, db_batch_size,                     "af_db_batch_size"                     );
+	getVar( i_obj, db_queue_max,                      "af_db_queue_max"                      );
 
 	getVar( i_obj, server_sockets_readwrite_threads_num,    "af_server_sockets_readwrite_threads_num"    );
 	getVar( i_obj, server_sockets_readwrite_threads_stack,  "af_server_sockets_readwrite_threads_stack"  );
@@ -228,7 +248,16 @@ void Environment::getVars( const JSON * i_obj)
 	getVar( i_obj, server_sockets_processing_threads_stack, "af_server_sockets_processing_threads_stack" );
 
 	getVar( i_obj, server_linux_epoll,                "af_server_linux_epoll"                );
+	getVar( i_obj, server_connection_keep_alive_sec,  "af_server_connection_keep_alive_sec"  );
 	getVar( i_obj, server_profiling_sec,              "af_server_profiling_sec"              );
+	getVar( i_obj, server_response_cache_size,        "af_server_response_cache_size"        );
+	getVar( i_obj, server_output_compress_level,      "af_server_output_compress_level"      );
+	getVar( i_obj, server_run_cycle_min_msec,         "af_server_run_cycle_min_msec"         );
+	getVar( i_obj, server_run_cycle_max_msec,         "af_server_run_cycle_max_msec"         );
+	getVar( i_obj, server_store_tasks_progress_log,         "af_server_store_tasks_progress_log"         );
+	getVar( i_obj, server_store_tasks_progress_log_compact, "af_server_store_tasks_progress_log_compact" );
+	getVar( i_obj, server_store_load_threads,               "af_server_store_load_threads"               );
+	getVar( i_obj, server_file_queue_threads,               "af_server_file_queue_threads"               );
 
 	/// Socket Options:
 	getVar( i_obj, so_server_LINGER,                  "af_so_server_LINGER"                  );
@@ -257,6 +286,7 @@ void Environment::getVars( const JSON * i_obj)
 	getVar( i_obj, solving_simpler,                   "af_solving_simpler"                   );
 	getVar( i_obj, solving_tasks_speed,               "af_solving_tasks_speed"               );
 	getVar( i_obj, solving_wake_per_cycle,            "af_solving_wake_per_cycle"            );
+	getVar( i_obj, solving_incremental,               "af_solving_incremental"               );
 
 	getVar( i_obj, render_heartbeat_sec,              "af_render_heartbeat_sec"              );
 	getVar( i_obj, render_up_resources_period,        "af_render_up_resources_period"        );
@@ -274,6 +304,11 @@ void Environment::getVars( const JSON * i_obj)
 	getVar( i_obj, render_zombietime,                 "af_render_zombietime"                 );
 	getVar( i_obj, render_exit_no_task_time,          "af_render_exit_no_task_time"          );
 	getVar( i_obj, render_connectretries,             "af_render_connectretries"             );
+	getVar( i_obj, render_server_connection_keep,     "af_render_server_connection_keep"     );
+	getVar( i_obj, render_events_wait,                "af_render_events_wait"                );
+	getVar( i_obj, render_parsers_native,             "af_render_parsers_native"             );
+	getVar( i_obj, render_output_compress_level,      "af_render_output_compress_level"      );
+	getVar( i_obj, render_output_stream_budget,       "af_render_output_stream_budget"       );
 	getVar( i_obj, render_windowsmustdie,             "af_render_windowsmustdie"             );
 
 	getVar( i_obj, rendercmds,                        "af_rendercmds"                        );
@@ -284,6 +319,7 @@ void Environment::getVars( const JSON * i_obj)
 	getVar( i_obj, watch_render_idle_bar_max,         "af_watch_render_idle_bar_max"         );
 
 	getVar( i_obj, monitor_zombietime,                "af_monitor_zombietime"                );
+	getVar( i_obj, monitor_events_wait_sec,           "af_monitor_events_wait_sec"           );
 
 	getVar( i_obj, errors_forgivetime,                "af_errors_forgivetime"                );
 	getVar( i_obj, errors_avoid_host,                 "af_errors_avoid_host"                 );
@@ -93,6 +93,7 @@ public:
 	static inline const std::vector<std::string> & getRenderCmdsAdmin() { return rendercmds_admin; } ///< Get render commands for admin
 
 	static inline int getMonitorZombieTime()             { return monitor_zombietime;           }
+	static inline int getMonitorEventsWaitSec()          { return monitor_events_wait_sec;      }
 
 	static inline int getWatchGetEventsSec()           { return watch_get_events_sec;      }
 	static inline int getWatchRefreshGuiSec()          { return watch_refresh_gui_sec;     }
@@ -118,6 +119,7 @@ public:
 	static inline bool getSolvingSimpler()         { return solving_simpler;           }
 	static inline int  getSolvingTasksSpeed()      { return solving_tasks_speed;       }
 	static inline int  getSolvingWakePerCycle()    { return solving_wake_per_cycle;    }
+	static inline bool getSolvingIncremental()     { return solving_incremental;       }
 
 	static inline int getErrorsForgiveTime()             { return errors_forgivetime;           }
 	static inline int getErrorsAvoidHost()               { return errors_avoid_host;            }
@@ -140,6 +142,11 @@ public:
 	static inline int getRenderZombieTime()         { return render_zombietime;           }
 	static inline int getRenderExitNoTaskTime()     { return render_exit_no_task_time;    }
 	static inline int getRenderConnectRetries()     { return render_connectretries;       }
+	static inline bool getRenderServerConnectionKeep() { return render_server_connection_keep; }
+	static inline bool getRenderEventsWait()           { return render_events_wait;            }
+	static inline bool getRenderParsersNative()        { return render_parsers_native;         }
+	static inline int  getRenderOutputCompressLevel()  { return render_output_compress_level;  }
+	static inline int  getRenderOutputStreamBudget()   { return render_output_stream_budget;   }
 
 	static inline bool hasRULES() { return rules_url.size(); }
 	static inline std::vector<std::string> & getRenderWindowsMustDie() { return render_windowsmustdie; }
@@ -165,6 +172,8 @@ public:
 	static inline const std::string & get_DB_StringQuotes()    { return db_stringquotes; } ///< Get database string quotes.
 	static inline int                 get_DB_StringNameLen()   { return db_stringnamelen;} ///< Get database string name length.
 	static inline int                 get_DB_StringExprLen()   { return db_stringexprlen;} ///< Get database string expression length.
+	static inline int                 get_DB_BatchSize()       { return db_batch_size;   } ///< Get database records batch size.
+	static inline int                 get_DB_QueueMax()        { return db_queue_max;    } ///< Get database queue maximum size in memory.
 
 	static inline int getServerSocketsReadWriteThreadsNum()    { return server_sockets_readwrite_threads_num;    }
 	static inline int getServerSocketsReadWriteThreadsStack()  { return server_sockets_readwrite_threads_stack;  }
@@ -172,9 +181,21 @@ public:
 	static inline int getServerSocketsProcessingThreadsStack() { return server_sockets_processing_threads_stack; }
 
 	static inline int getServerLinuxEpoll() { return server_linux_epoll; }
+	static inline int getServerConnectionKeepAliveSec() { return server_connection_keep_alive_sec; }
 
 	static inline int getServerProfilingSec() { return server_profiling_sec; }
 
+	static inline int getServerResponseCacheSize() { return server_response_cache_size; }
+	static inline int getServerOutputCompressLevel() { return server_output_compress_level; }
+
+	static inline int getServerRunCycleMinMSec() { return server_run_cycle_min_msec; }
+	static inline int getServerRunCycleMaxMSec() { return server_run_cycle_max_msec; }
+
+	static inline bool getServerStoreTasksProgressLog()        { return server_store_tasks_progress_log;         }
+	static inline int  getServerStoreTasksProgressLogCompact() { return server_store_tasks_progress_log_compact; }
+	static inline int  getServerStoreLoadThreads()             { return server_store_load_threads;               }
+	static inline int  getServerFileQueueThreads()             { return server_file_queue_threads;               }
+
 	/// Socket Options:
 	static inline int getSO_LINGER()       { return m_server ? so_server_LINGER       : so_client_LINGER       ;}
 	static inline int getSO_REUSEADDR()    { return m_server ? so_server_REUSEADDR    : so_client_REUSEADDR    ;}
@@ -275,6 +296,7 @@ private:
 	static int watch_render_idle_bar_max;
 
 	static int monitor_zombietime;
+	static int monitor_events_wait_sec;
 
 	static std::string timeformat;    ///< Default time format.
 
@@ -290,6 +312,7 @@ private:
 	static bool solving_simpler;            ///< Sort jobs by priority and creation time instead of using the "Need"
 	static int  solving_tasks_speed;
 	static int  solving_wake_per_cycle;
+	static bool solving_incremental;        ///< Keep solving nodes and renders sorted across a cycle
 
 	static int render_heartbeat_sec;
 	static int render_up_resources_period;
@@ -299,6 +322,11 @@ private:
 	static int render_zombietime;
 	static int render_exit_no_task_time;
 	static int render_connectretries;
+	static bool render_server_connection_keep;
+	static bool render_events_wait;
+	static bool render_parsers_native;
+	static int  render_output_compress_level;
+	static int  render_output_stream_budget;
 	static std::vector<std::string> render_windowsmustdie;
 
 	static std::string cmd_shell;
@@ -333,6 +361,8 @@ private:
 	static std::string db_stringquotes;   ///< Database string quotes
 	static int         db_stringnamelen;  ///< Database string name length
 	static int         db_stringexprlen;  ///< Database string expression length
+	static int         db_batch_size;     ///< Database records batch size
+	static int         db_queue_max;      ///< Database queue maximum size in memory
 
 	// Server incoming connections:
 	static int server_sockets_readwrite_threads_num;
@@ -341,8 +371,19 @@ private:
 	static int server_sockets_processing_threads_stack;
 
 	static int server_linux_epoll;
+	static int server_connection_keep_alive_sec;
 
 	static int server_profiling_sec;
+	static int server_response_cache_size;
+	static int server_output_compress_level;
+
+	static int server_run_cycle_min_msec;
+	static int server_run_cycle_max_msec;
+
+	static bool server_store_tasks_progress_log;
+	static int  server_store_tasks_progress_log_compact;
+	static int  server_store_load_threads;
+	static int  server_file_queue_threads;
 
 	/// Socket Options:
 	static int so_server_LINGER;
@@ -0,0 +1,63 @@
+#include "idcounters.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+using namespace af;
+
+IdCounters::IdCounters():
+	m_ids_num( 0)
+{
+}
+
+IdCounters::~IdCounters()
+{
+}
+
+void IdCounters::increment( int i_id)
+{
+	if( i_id < 0 )
+	{
+		AF_ERR << "Invalid id = " << i_id;
+		return;
+	}
+
+	if( i_id >= int( m_counts.size()))
+		m_counts.resize( i_id + 1, 0);
+
+	if( m_counts[i_id] == 0 )
+		m_ids_num++;
+
+	m_counts[i_id]++;
+}
+
+void IdCounters::decrement( int i_id)
+{
+	if( get( i_id) <= 0 )
+		return;
+
+	m_counts[i_id]--;
+
+	if( m_counts[i_id] == 0 )
+	{
+		m_ids_num--;
+
+		// Free memory, there are many jobs and blocks with no running tasks:
+		if( m_ids_num == 0 )
+			clear();
+	}
+}
+
+void IdCounters::clear()
+{
+	std::vector<int32_t> empty;
+	m_counts.swap( empty);
+	m_ids_num = 0;
+}
+
+int IdCounters::weigh() const
+{
+	return sizeof( IdCounters) + m_counts.capacity() * sizeof( int32_t);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "name_af.h"
+
+namespace af
+{
+/// Counters indexed by node id.
+/** Node ids are small positive numbers (container indexes), so a dense array is used.
+*** Get, increment and decrement are O(1).
+*** Memory is freed when all counters become zero. **/
+class IdCounters
+{
+public:
+	IdCounters();
+	~IdCounters();
+
+	inline int get( int i_id) const
+		{ return (( i_id >= 0 ) && ( i_id < int( m_counts.size()))) ? m_counts[i_id] : 0; }
+
+	/// Number of ids with a non zero counter.
+	inline int getIdsNum() const { return m_ids_num; }
+
+	void increment( int i_id);
+	void decrement( int i_id);
+
+	void clear();
+
+	int weigh() const;
+
+private:
+	std::vector<int32_t> m_counts;
+	int m_ids_num;
+};
+}
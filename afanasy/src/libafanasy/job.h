@@ -121,6 +121,12 @@ public:
 	inline bool checkNeedOS(            const std::string & str ) const { return m_need_os.match( str);           }
 	inline bool checkNeedProperties(    const std::string & str ) const { return m_need_properties.match( str);   }
 
+	/// Cached checks, \c cache is a render cache of the \c str matches.
+	inline bool checkHostsMask(         const std::string & str, RegExpCache & cache ) const { return m_hosts_mask.match( str, cache);         }
+	inline bool checkHostsMaskExclude(  const std::string & str, RegExpCache & cache ) const { return m_hosts_mask_exclude.match( str, cache); }
+	inline bool checkNeedOS(            const std::string & str, RegExpCache & cache ) const { return m_need_os.match( str, cache);            }
+	inline bool checkNeedProperties(    const std::string & str, RegExpCache & cache ) const { return m_need_properties.match( str, cache);    }
+
 	inline int32_t getRunningTasksNumber() const /// Get job running tasks.
 		{int32_t n=0;for(int b=0;b<m_blocks_num;b++)n+=m_blocks_data[b]->getRunningTasksNumber();return n;}
 
@@ -63,6 +63,7 @@ void JobProgress::initProperties()
 	m_job_id = 0;
 	tasksnum = NULL;
 	tp = NULL;
+	m_tasks = NULL;
 	m_blocks_num = 0;
 }
 
@@ -76,6 +77,7 @@ bool JobProgress::initBlocks()
 
    tasksnum = new int32_t        [ m_blocks_num];
    tp       = new TaskProgress **[ m_blocks_num]();
+   m_tasks  = new TaskProgress  *[ m_blocks_num]();
 
    return true;
 }
@@ -87,18 +89,14 @@ bool JobProgress::initTasks( int block, int numtasks)
       AFERROR("JobProgress::initTasks: numtasks == 0\n");
       return false;
    }
+   m_tasks[block] = new TaskProgress[ numtasks];
    tp[block] = new TaskProgress*[ numtasks];
-   for( int t = 0; t < tasksnum[block]; t++)
-      tp[block][t] = newTaskProgress();
+   for( int t = 0; t < numtasks; t++)
+      tp[block][t] = &(m_tasks[block][t]);
 
    return true;
 }
 
-TaskProgress * JobProgress::newTaskProgress() const
-{
-   return new TaskProgress;
-}
-
 JobProgress::~JobProgress()
 {
 AFINFA("JobProgress::~JobProgress: Job Id = %d", m_job_id)
@@ -107,16 +105,11 @@ AFINFA("JobProgress::~JobProgress: Job Id = %d", m_job_id)
       AFINFO("JobProgress::~JobProgress: Deleting tasks running information.")
       for( int b = 0; b < m_blocks_num; b++)
       {
-         if( tp[b] != NULL )
-         {
-            for( int t = 0; t < tasksnum[b]; t++)
-            {
-               if( tp[b][t] != NULL) delete tp[b][t];
-            }
-            delete [] tp[b];
-         }
+         if( tp[b] != NULL ) delete [] tp[b];
+         if( m_tasks[b] != NULL ) delete [] m_tasks[b];
       }
       delete [] tp;
+      delete [] m_tasks;
    }
    if( tasksnum != NULL ) delete [] tasksnum;
 }
@@ -185,7 +178,7 @@ int JobProgress::calcWeight() const
       weight += sizeof(*tasksnum);
       weight += tasksnum[b] * sizeof(**tp);
       for( int t = 0; t < tasksnum[b]; t++)
-         weight += tp[b][t]->calcWeight();
+         weight += m_tasks[b][t].calcWeight();
    }
    return weight;
 }
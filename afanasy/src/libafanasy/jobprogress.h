@@ -33,12 +33,16 @@ public:
    inline int getTasksNum( int b) const
       { if( b < m_blocks_num ) return tasksnum[b]; else return -1;}
 
+/// Get contiguous tasks progress array of \c b block.
+   inline TaskProgress * getTasksProgress( int b) { return m_tasks[b]; }
+   inline const TaskProgress * getTasksProgress( int b) const { return m_tasks[b]; }
+
    virtual int calcWeight() const;                   ///< Calculate and return memory size.
 
 	void jsonWrite( std::ostringstream & o_str) const;
 
 public:
-   TaskProgress  ***tp;
+   TaskProgress  ***tp; ///< Pointers to tasks progress, point into \c m_tasks arrays.
 
 protected:
    bool construct( Job * job);               ///< Construct progress blocks and tasks data.
@@ -51,7 +55,11 @@ protected:
 
 private:
 	void initProperties();
-	virtual TaskProgress * newTaskProgress() const;
+
+private:
+	/// Tasks progress per block, allocated as a single array per block,
+	/// so block progress scans walk memory sequentially.
+	TaskProgress ** m_tasks;
 
 private:
    int32_t m_job_id;               ///< Job id.
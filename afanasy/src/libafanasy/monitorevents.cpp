@@ -335,6 +335,18 @@ void MonitorEvents::clear()
 	m_message.clear();
 }
 
+void MonitorEvents::swap( MonitorEvents & io_other)
+{
+	m_events.swap( io_other.m_events);
+	m_tp.swap( io_other.m_tp);
+	m_bids.swap( io_other.m_bids);
+	m_jobs_order_ids.swap( io_other.m_jobs_order_ids);
+	m_instruction.swap( io_other.m_instruction);
+	m_listens.swap( io_other.m_listens);
+	m_outputs.swap( io_other.m_outputs);
+	m_message.swap( io_other.m_message);
+}
+
 bool MonitorEvents::isEmpty() const
 {
 	for( int e = 0; e < m_events.size(); e++)
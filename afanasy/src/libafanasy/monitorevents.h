@@ -61,6 +61,9 @@ public:
 
 	void clear();
 
+	/// Exchange events with other, without copying.
+	void swap( MonitorEvents & io_other);
+
 private:
 	void v_readwrite( Msg * msg);
 };
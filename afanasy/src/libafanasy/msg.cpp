@@ -201,6 +201,62 @@ bool Msg::setData( int i_size, const char * i_msgData, int i_type)
 	return true;
 }
 
+bool Msg::setDataBuffer( char * i_buffer, int i_buffer_size, int i_data_len, int i_type)
+{
+	if(checkZero( true) == false )
+	{
+		delete [] i_buffer;
+		return false;
+	}
+
+	if(( i_buffer == NULL ) ||
+		( i_data_len <= 0 ) ||
+		( i_data_len > Msg::SizeDataMax ) ||
+		( i_buffer_size < i_data_len + Msg::SizeHeader ))
+	{
+		AFERROR("Msg::setDataBuffer(): invalid arguments.")
+		if( i_buffer ) delete [] i_buffer;
+		setInvalid();
+		return false;
+	}
+
+	delete [] m_buffer;
+	m_buffer       = i_buffer;
+	m_buffer_size  = i_buffer_size;
+	m_data         = m_buffer      + Msg::SizeHeader;
+	m_data_maxsize = m_buffer_size - Msg::SizeHeader;
+
+	m_type = i_type;
+	m_int32 = i_data_len;
+	m_writing = true;
+
+	// Default header type for JSON - not binary
+	// So we should skip binary header at all
+	if(( m_type == Msg::TJSON ) || ( m_type == Msg::THTTPGET ))
+		m_header_offset = Msg::SizeHeader;
+
+	rw_header( true);
+
+	return true;
+}
+
+char * Msg::dataTerminated()
+{
+	if( m_type < Msg::TDATA )
+		return NULL;
+
+	if( m_int32 >= m_data_maxsize )
+	{
+		if( false == allocateBuffer( Msg::SizeHeader + m_int32 + 1, m_int32))
+			return NULL;
+		rw_header( true);
+	}
+
+	m_data[m_int32] = '\0';
+
+	return m_data;
+}
+
 void Msg::setJSONBIN()
 {
 	if( m_type != TJSON )
@@ -528,9 +584,9 @@ const char * Msg::TNAMES[]=
 	"TJobsWeightRequest",         ///< Request all jobs weight.
 
 
-	"TRESERVED00",
-	"TRESERVED01",
-	"TRESERVED02",
+	"TKeepAlive",
+	"TRenderEventsWait",
+	"TMonitorEventsWait",
 	"TRESERVED03",
 	"TRESERVED04",
 	"TRESERVED05",
@@ -43,6 +43,10 @@ public:
 		/// On TJSON header type will be not binary - binary header will be skipped at all.
 	bool setData( int i_size, const char * i_msgData, int i_type = TDATA);
 
+	/// Set data message taking an allocated buffer, no data is copied.
+	/** Data should be written in the buffer after header size. Buffer will be deleted by message. **/
+	bool setDataBuffer( char * i_buffer, int i_buffer_size, int i_data_len, int i_type = TDATA);
+
 	/// To JSON data message with binary header (not for python or browser).
 	void setJSONBIN();
 //	bool setJSON_headerBin( const std::string & i_str);
@@ -96,7 +100,17 @@ public:
 /**/TJobsWeightRequest/**/,         ///< Request all jobs weight.
 
 
-TRESERVED00,TRESERVED01,TRESERVED02,TRESERVED03,TRESERVED04,TRESERVED05,TRESERVED06,TRESERVED07,TRESERVED08,TRESERVED09,
+/// Ask server to keep a connection open for next messages.
+/** Server answers the same type with an idle timeout in seconds, zero means that the connection will be closed. **/
+/**/TKeepAlive/**/,
+
+/// Render waits for its events, server answers as soon as events are published, or on heartbeat timeout.
+/**/TRenderEventsWait/**/,
+
+/// Monitor waits for its events, server answers as soon as events are dispatched, or on wait timeout.
+/**/TMonitorEventsWait/**/,
+
+TRESERVED03,TRESERVED04,TRESERVED05,TRESERVED06,TRESERVED07,TRESERVED08,TRESERVED09,
 
 /*---------------------------------------------------------------------------------------------------------*/
 /*--------------------------------- DATA MESSAGES ---------------------------------------------------------*/
@@ -156,6 +170,10 @@ TLAST
 
 	inline int   type()    const { return m_type;  }///< Get message type.
 	inline char* data()    const { return m_data;  }///< Get data pointer.
+
+	/// Get data pointer with zero after data, to parse it in place.
+	/** Buffer is reallocated if there is no space for zero. **/
+	char * dataTerminated();
 	inline int   dataLen() const { return m_int32; }///< Get data length.
 	inline int   int32()   const { return m_int32; }///< Get 32-bit integer, data lenght for data messages.
 
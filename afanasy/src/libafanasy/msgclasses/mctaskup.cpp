@@ -8,6 +8,7 @@
 #define AFOUTPUT
 #undef AFOUTPUT
 #include "../../include/macrooutput.h"
+#include "../logger.h"
 
 using namespace af;
 
@@ -53,6 +54,9 @@ MCTaskUp::MCTaskUp
 
 	m_datalen       ( i_datalen ),
 	m_data          ( i_data ),
+	m_data_compressed( false),
+	m_data_rawlen( 0),
+	m_data_offset( -1),
 	m_deleteData    ( false), // Don not delete data on client side, as it is not copied
 
 	m_files_num(0),
@@ -62,6 +66,9 @@ MCTaskUp::MCTaskUp
 
 MCTaskUp::MCTaskUp( Msg * msg):
 	m_data ( NULL),
+	m_data_compressed( false),
+	m_data_rawlen( 0),
+	m_data_offset( -1),
 	m_files_data( NULL),
 	m_deleteData( true)       // Delete data on server side, as it was allocated and copied from incoming message
 {
@@ -107,6 +114,9 @@ void MCTaskUp::v_readwrite( Msg * msg)
 
 	rw_StringVect( m_parsed_files, msg);
 	rw_int32_t(    m_datalen,      msg);
+	rw_bool(       m_data_compressed, msg);
+	rw_int32_t(    m_data_rawlen,  msg);
+	rw_int64_t(    m_data_offset,  msg);
 	rw_int32_t(    m_files_num,    msg);
 
 	if( m_datalen )
@@ -139,6 +149,57 @@ void MCTaskUp::rwData( Msg * msg)
 	rw_data( m_data, msg, m_datalen);
 }
 
+void MCTaskUp::copyData( const char * i_data, int i_size)
+{
+	if( m_deleteData && m_data ) delete [] m_data;
+
+	m_datalen = i_size;
+	m_data = new char[m_datalen];
+	memcpy( m_data, i_data, m_datalen);
+	m_deleteData = true;
+	m_data_compressed = false;
+}
+
+bool MCTaskUp::compressData( int i_level)
+{
+	if( m_data_compressed || ( m_data == NULL ) || ( m_datalen < 1 ))
+		return false;
+
+	std::string zdata;
+	if( false == af::gzCompress( m_data, m_datalen, zdata, i_level))
+		return false;
+
+	if( zdata.size() >= m_datalen )
+		return false;
+
+	// Client side data is not owned by this class, so we can't delete it here:
+	if( m_deleteData ) delete [] m_data;
+
+	m_data_rawlen = m_datalen;
+	m_datalen = zdata.size();
+	m_data = new char[m_datalen];
+	memcpy( m_data, zdata.data(), m_datalen);
+	m_deleteData = true;
+	m_data_compressed = true;
+
+	return true;
+}
+
+const std::string MCTaskUp::getDataString() const
+{
+	if(( m_data == NULL ) || ( m_datalen < 1 ))
+		return std::string();
+
+	if( false == m_data_compressed )
+		return std::string( m_data, m_datalen);
+
+	std::string data, err;
+	if( false == af::gzDecompress( m_data, m_datalen, data, -1, &err))
+		AF_ERR << err;
+
+	return data;
+}
+
 void MCTaskUp::rwFiles( Msg * msg)
 {
 	rw_int32_t(    m_files_data_len, msg);
@@ -208,10 +269,12 @@ void MCTaskUp::v_generateInfoStream( std::ostringstream & stream, bool full) con
 			<< ", report="   << m_report
 			<< ", log="      << m_log
 			<< ", datalen="  << m_datalen
+			<< ", compressed=" << m_data_compressed
+			<< ", offset="   << m_data_offset
 			<< ", files="    << m_files_num
 			<< ", status="   << int(m_status)
 			<< ", percent="  << int(m_percent);
-		if( m_datalen && m_data) stream << "data:\n" << std::string( m_data, m_datalen) << std::endl;
+		if( m_datalen && m_data) stream << "data:\n" << getDataString() << std::endl;
 	}
 	else
 	{
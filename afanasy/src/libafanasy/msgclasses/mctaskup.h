@@ -51,6 +51,22 @@ public:
   	inline const std::string & getLog()      const { return m_log;           }
 	inline int getDataLen()                  const { return m_datalen;       }
 	inline const char * getData()            const { return m_data;          }
+	inline bool isDataCompressed()           const { return m_data_compressed; }
+	inline int getDataRawLen()               const { return m_data_compressed ? m_data_rawlen : m_datalen; }
+
+	/// Output stream offset of data, negative means that data is the whole output.
+	inline int64_t getDataOffset()           const { return m_data_offset; }
+	inline void setDataOffset( int64_t i_offset) { m_data_offset = i_offset; }
+
+	/// Set output data copy, by default data is not copied on client side.
+	void copyData( const char * i_data, int i_size);
+
+	/// Compress output data in gzip format, returns false if data was not compressed.
+	/** Data is not compressed if it is empty, or compressed data is not smaller. **/
+	bool compressData( int i_level);
+
+	/// Get output data as a string, decompressing it if needed.
+	const std::string getDataString() const;
 
 	inline bool hasListened()                const { return m_listened.size(); }
 	inline const std::string & getListened() const { return m_listened;        }
@@ -90,6 +106,9 @@ private:
 
 	int32_t m_datalen;
 	char * m_data;
+	bool m_data_compressed;
+	int32_t m_data_rawlen;
+	int64_t m_data_offset;
 
 	std::vector<std::string> m_parsed_files;
 
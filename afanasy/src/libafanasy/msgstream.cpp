@@ -0,0 +1,125 @@
+#include "msgstream.h"
+
+#include <string.h>
+
+#include "name_af.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "logger.h"
+
+using namespace af;
+
+MsgStream::MsgStream()
+{
+	// Redirect stream output to message buffer, string buffer is not used.
+	std::basic_ios<char>::rdbuf( &m_buffer);
+}
+
+MsgStream::~MsgStream()
+{
+}
+
+Msg * MsgStream::generateMsg( int i_type)
+{
+	if( fail())
+	{
+		AF_ERR << "Message stream writing failed, maximum message size reached.";
+		return af::jsonMsgError("Maximum message size overload.");
+	}
+
+	int buffer_size, data_len;
+	char * buffer = m_buffer.take( buffer_size, data_len);
+
+	Msg * msg = new Msg();
+	msg->setDataBuffer( buffer, buffer_size, data_len, i_type);
+	return msg;
+}
+
+MsgStream::Buffer::Buffer():
+	m_buffer( NULL),
+	m_buffer_size( 0)
+{
+	grow( Msg::SizeBuffer);
+}
+
+MsgStream::Buffer::~Buffer()
+{
+	if( m_buffer )
+		delete [] m_buffer;
+}
+
+bool MsgStream::Buffer::grow( int i_size)
+{
+	if( i_size <= m_buffer_size )
+		return true;
+
+	if( i_size > Msg::SizeBufferLimit )
+		return false;
+
+	int size = m_buffer_size << 1;
+	if( size < i_size )
+		size = i_size;
+	if( size > Msg::SizeBufferLimit )
+		size = Msg::SizeBufferLimit;
+
+	char * buffer = new char[size];
+
+	int written = 0;
+	if( m_buffer )
+	{
+		written = pptr() - pbase();
+		memcpy( buffer + Msg::SizeHeader, m_buffer + Msg::SizeHeader, written);
+		delete [] m_buffer;
+	}
+
+	m_buffer = buffer;
+	m_buffer_size = size;
+
+	setp( m_buffer + Msg::SizeHeader, m_buffer + m_buffer_size);
+	pbump( written);
+
+	return true;
+}
+
+MsgStream::Buffer::int_type MsgStream::Buffer::overflow( int_type i_c)
+{
+	if( traits_type::eq_int_type( i_c, traits_type::eof()))
+		return traits_type::not_eof( i_c);
+
+	if( false == grow( m_buffer_size + 1))
+		return traits_type::eof();
+
+	*pptr() = traits_type::to_char_type( i_c);
+	pbump( 1);
+
+	return i_c;
+}
+
+std::streamsize MsgStream::Buffer::xsputn( const char * i_s, std::streamsize i_n)
+{
+	if( epptr() - pptr() < i_n )
+	{
+		if( false == grow( m_buffer_size + i_n))
+			return 0;
+	}
+
+	memcpy( pptr(), i_s, i_n);
+	pbump( i_n);
+
+	return i_n;
+}
+
+char * MsgStream::Buffer::take( int & o_buffer_size, int & o_data_len)
+{
+	char * buffer = m_buffer;
+	o_buffer_size = m_buffer_size;
+	o_data_len = pptr() - pbase();
+
+	m_buffer = NULL;
+	m_buffer_size = 0;
+	setp( NULL, NULL);
+
+	return buffer;
+}
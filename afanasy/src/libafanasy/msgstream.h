@@ -0,0 +1,46 @@
+#pragma once
+
+#include <sstream>
+
+#include "msg.h"
+
+namespace af
+{
+/// Stream that writes data directly into a message buffer.
+/** It is an std::ostringstream to be passed to nodes v_jsonWrite() functions,
+*** but its output is redirected to a growing buffer, so str() is always empty.
+*** Message takes this buffer, data is not copied to a string and then to a message. **/
+class MsgStream : public std::ostringstream
+{
+public:
+	MsgStream();
+	~MsgStream();
+
+	/// Construct message with written data, stream should not be used after.
+	Msg * generateMsg( int i_type = Msg::TJSON);
+
+private:
+	class Buffer : public std::streambuf
+	{
+	public:
+		Buffer();
+		~Buffer();
+
+		/// Take written buffer, message header space is reserved at its beginning.
+		char * take( int & o_buffer_size, int & o_data_len);
+
+	protected:
+		virtual int_type overflow( int_type i_c);
+		virtual std::streamsize xsputn( const char * i_s, std::streamsize i_n);
+
+	private:
+		bool grow( int i_size);
+
+	private:
+		char * m_buffer;
+		int m_buffer_size;
+	};
+
+	Buffer m_buffer;
+};
+}
@@ -209,6 +209,23 @@ namespace af
 	bool removeDir( const std::string & i_folder );
 //
 
+//
+// Data compression functions name_afzip.cpp:
+//
+	/// Check gzip magic bytes.
+	bool gzIsCompressed( const char * i_data, int i_size);
+
+	/// Compress data in gzip format, returns false on error or if built without zlib.
+	bool gzCompress( const char * i_data, int i_size, std::string & o_data, int i_level);
+
+	/// Decompress gzip data, output is truncated to i_maxsize if it is positive.
+	/** Data can consist of several gzip members, like appended portions of a file. **/
+	bool gzDecompress( const char * i_data, int i_size, std::string & o_data, int i_maxsize = -1, std::string * o_err = NULL);
+
+	/// Read file like fileRead(), decompressing it if it is gzip compressed.
+	char * fileReadDecompress( const std::string & i_filename, int * o_size = NULL, int i_maxfilesize = -1, std::string * o_err = NULL);
+//
+
 	bool netIsIpAddr( const std::string & addr, bool verbose = false);
 
 #ifdef WINNT
@@ -257,6 +274,10 @@ namespace af
 	bool msgwrite( int i_desc, const af::Msg * i_msg);
 	char * msgMakeWriteHeader( const af::Msg * i_msg);
 
+	/// Create a socket and connect it to the address.
+	/** Return socket descriptor or -1 on failure, message is used for error output only. **/
+	int connectToAddress( const af::Address & i_address, const af::Msg * i_msg, VerboseMode i_verbose);
+
 	/// Send a message to all its addresses and receive an answer if needed
 	Msg * sendToServer( Msg * i_msg, bool & o_ok, VerboseMode i_verbose);
 
@@ -273,6 +294,8 @@ namespace af
 	// JSON:
 	char * jsonParseData( rapidjson::Document & o_doc, const char * i_data, int i_data_len, std::string * o_err = NULL);
 	char * jsonParseMsg( rapidjson::Document & o_doc, const af::Msg * i_msg, std::string * o_err = NULL);
+	/// Parse message data in its buffer without a copy, message data is changed by parser.
+	bool jsonParseMsgInsitu( rapidjson::Document & o_doc, af::Msg * io_msg, std::string * o_err = NULL);
 	bool jr_string( const char * i_name, std::string & o_attr, const JSON & i_object, std::string * o_str = NULL);
 	bool jr_regexp( const char * i_name, RegExp      & o_attr, const JSON & i_object, std::string * o_str = NULL);
 	bool jr_bool  ( const char * i_name, bool        & o_attr, const JSON & i_object, std::string * o_str = NULL);
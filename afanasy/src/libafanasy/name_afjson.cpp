@@ -11,27 +11,11 @@
 #undef AFOUTPUT
 #include "../include/macrooutput.h"
 
-char * af::jsonParseMsg( rapidjson::Document & o_doc, const af::Msg * i_msg, std::string * o_err)
-{
-	return af::jsonParseData( o_doc, i_msg->data(), i_msg->dataLen(), o_err);
-}
-
-char * af::jsonParseData( rapidjson::Document & o_doc, const char * i_data, int i_data_len, std::string * o_err)
+/// Parse zero terminated data in place, source data is used for an error message.
+static bool jsonParseInsitu( rapidjson::Document & o_doc, char * io_data, const char * i_source, int i_data_len, std::string * o_err)
 {
-    if( i_data_len < 0 || i_data_len > Msg::SizeBufferLimit)
-    {
-        if( o_err )
-            *o_err = "Invalid buffer size";
-        AFERRAR("jsonParseData: size > Msg::SizeBufferLimit ( %d > %d)", i_data_len, Msg::SizeBufferLimit);
-        return NULL;
-    }
-	char * data = new char[i_data_len+1];
-	memcpy( data, i_data, i_data_len);
-	data[i_data_len] = '\0';
-//printf("af::jsonParseMsg:\n");printf("%s\n", data);
-
 	std::string err;
-	if( o_doc.ParseInsitu<0>(data).HasParseError())
+	if( o_doc.ParseInsitu<0>( io_data).HasParseError())
 	{
 		int pos = o_doc.GetErrorOffset();
 		err = err + "JSON: " + o_doc.GetParseError();
@@ -44,28 +28,66 @@ char * af::jsonParseData( rapidjson::Document & o_doc, const char * i_data, int
 			int end = pos + offset;
 			if( end >= i_data_len ) end = i_data_len - 1;
 			err += std::string( offset, ' ') + "!\n";
-			err += af::strReplace( af::strReplace( std::string( i_data + begin, end - begin), '\n', ' '), '\t', ' ');
+			err += af::strReplace( af::strReplace( std::string( i_source + begin, end - begin), '\n', ' '), '\t', ' ');
 		}
-		delete [] data;
-		data = NULL;
 	}
-
-	if( data && ( false == o_doc.IsObject()))
+	else if( false == o_doc.IsObject())
 	{
 		err = "JSON frist 100 characters:\n";
-		err += std::string( i_data, i_data_len < 100 ? i_data_len : 100);
+		err += std::string( i_source, i_data_len < 100 ? i_data_len : 100);
 		err += ":\n";
 		err += "JSON: Can't find root object.";
-		delete [] data;
-		data = NULL;
 	}
 
-	if( err.size())
+	if( err.empty())
+		return true;
+
+	if( o_err )
+		*o_err = err;
+	else
+		AFERRAR("%s", err.c_str())
+
+	return false;
+}
+
+char * af::jsonParseMsg( rapidjson::Document & o_doc, const af::Msg * i_msg, std::string * o_err)
+{
+	return af::jsonParseData( o_doc, i_msg->data(), i_msg->dataLen(), o_err);
+}
+
+bool af::jsonParseMsgInsitu( rapidjson::Document & o_doc, af::Msg * io_msg, std::string * o_err)
+{
+	char * data = io_msg->dataTerminated();
+	if( NULL == data )
 	{
 		if( o_err )
-			*o_err = err;
-		else
-			AFERRAR("%s", err.c_str())
+			*o_err = "Invalid message buffer";
+		return false;
+	}
+
+	// Data is not copied, but message can't be parsed again.
+	// Source data for an error message is already changed by parser.
+	return jsonParseInsitu( o_doc, data, data, io_msg->dataLen(), o_err);
+}
+
+char * af::jsonParseData( rapidjson::Document & o_doc, const char * i_data, int i_data_len, std::string * o_err)
+{
+    if( i_data_len < 0 || i_data_len > Msg::SizeBufferLimit)
+    {
+        if( o_err )
+            *o_err = "Invalid buffer size";
+        AFERRAR("jsonParseData: size > Msg::SizeBufferLimit ( %d > %d)", i_data_len, Msg::SizeBufferLimit);
+        return NULL;
+    }
+	char * data = new char[i_data_len+1];
+	memcpy( data, i_data, i_data_len);
+	data[i_data_len] = '\0';
+//printf("af::jsonParseMsg:\n");printf("%s\n", data);
+
+	if( false == jsonParseInsitu( o_doc, data, i_data, i_data_len, o_err))
+	{
+		delete [] data;
+		data = NULL;
 	}
 
 	return data;
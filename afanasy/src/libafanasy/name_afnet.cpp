@@ -196,35 +196,17 @@ int af::processHeader( af::Msg * io_msg, int i_bytes)
 	return af::Msg::SizeHeader;
 }
 
-af::Msg * msgsendtoaddress( const af::Msg * i_msg, const af::Address & i_address,
-						    bool & o_ok, af::VerboseMode i_verbose)
+int af::connectToAddress( const af::Address & i_address, const af::Msg * i_msg, af::VerboseMode i_verbose)
 {
-	if( af::Environment::isServer())
-	{
-		AFERROR("msgsendtoaddress: Server should not connect and send messages itself.\n")
-		o_ok = false;
-		return NULL;
-	}
-
-	o_ok = true;
-
-	if( i_address.isEmpty() )
-	{
-		AFERROR("msgsendtoaddress: Address is empty.")
-		o_ok = false;
-		return NULL;
-	}
-
 	int socketfd;
 	struct sockaddr_storage client_addr;
 
-	if( false == i_address.setSocketAddress( &client_addr)) return NULL;
+	if( false == i_address.setSocketAddress( &client_addr)) return -1;
 
 	if(( socketfd = socket( client_addr.ss_family, SOCK_STREAM, 0)) < 0 )
 	{
-		AFERRPE("msgsendtoaddress: socket() call failed")
-		o_ok = false;
-		return NULL;
+		AFERRPE("af::connectToAddress: socket() call failed")
+		return -1;
 	}
 
 
@@ -234,15 +216,43 @@ af::Msg * msgsendtoaddress( const af::Msg * i_msg, const af::Address & i_address
 
 	//
 	// connect to address
-	AFINFO("msgsendtoaddress: tying to connect to client.")
+	AFINFO("af::connectToAddress: tying to connect to client.")
 	if( connect(socketfd, (struct sockaddr*)&client_addr, i_address.sizeofAddr()) != 0 )
 	{
 		if( i_verbose == af::VerboseOn )
 		{
-			AFERRPA("msgsendtoaddress: connect failure for msgType '%s':\n%s: ",
+			AFERRPA("af::connectToAddress: connect failure for msgType '%s':\n%s: ",
 				af::Msg::TNAMES[i_msg->type()], i_address.v_generateInfoString().c_str())
 		}
 		closesocket(socketfd);
+		return -1;
+	}
+
+	return socketfd;
+}
+
+af::Msg * msgsendtoaddress( const af::Msg * i_msg, const af::Address & i_address,
+						    bool & o_ok, af::VerboseMode i_verbose)
+{
+	if( af::Environment::isServer())
+	{
+		AFERROR("msgsendtoaddress: Server should not connect and send messages itself.\n")
+		o_ok = false;
+		return NULL;
+	}
+
+	o_ok = true;
+
+	if( i_address.isEmpty() )
+	{
+		AFERROR("msgsendtoaddress: Address is empty.")
+		o_ok = false;
+		return NULL;
+	}
+
+	int socketfd = af::connectToAddress( i_address, i_msg, i_verbose);
+	if( socketfd < 0 )
+	{
 		o_ok = false;
 		return NULL;
 	}
@@ -0,0 +1,150 @@
+#include "name_af.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ZLIB_ON
+#include <zlib.h>
+#endif
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "logger.h"
+
+namespace
+{
+/// Deflate window bits with gzip header and trailer, so stored files can be read by gzip.
+const int GzWindowBits = 15 + 16;
+/// Decompression output portion size.
+const int GzChunkSize = 1 << 16;
+}
+
+bool af::gzIsCompressed( const char * i_data, int i_size)
+{
+	return ( i_size > 2 ) && ( (unsigned char)( i_data[0]) == 0x1f ) && ( (unsigned char)( i_data[1]) == 0x8b );
+}
+
+bool af::gzCompress( const char * i_data, int i_size, std::string & o_data, int i_level)
+{
+#ifdef ZLIB_ON
+	if( i_level > Z_BEST_COMPRESSION ) i_level = Z_BEST_COMPRESSION;
+	if( i_level < 1 ) i_level = 1;
+
+	z_stream zs;
+	memset( &zs, 0, sizeof( zs));
+	if( deflateInit2( &zs, i_level, Z_DEFLATED, GzWindowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+	{
+		AF_ERR << "deflateInit2 failed.";
+		return false;
+	}
+
+	o_data.resize( deflateBound( &zs, i_size));
+
+	zs.next_in   = (Bytef*)( i_data);
+	zs.avail_in  = i_size;
+	zs.next_out  = (Bytef*)( &o_data[0]);
+	zs.avail_out = o_data.size();
+
+	int result = deflate( &zs, Z_FINISH);
+	o_data.resize( zs.total_out);
+	deflateEnd( &zs);
+
+	if( result != Z_STREAM_END )
+	{
+		AF_ERR << "deflate failed: " << result;
+		o_data.clear();
+		return false;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool af::gzDecompress( const char * i_data, int i_size, std::string & o_data, int i_maxsize, std::string * o_err)
+{
+#ifdef ZLIB_ON
+	z_stream zs;
+	memset( &zs, 0, sizeof( zs));
+	if( inflateInit2( &zs, GzWindowBits) != Z_OK )
+	{
+		if( o_err ) *o_err = "inflateInit2 failed.";
+		return false;
+	}
+
+	zs.next_in  = (Bytef*)( i_data);
+	zs.avail_in = i_size;
+
+	o_data.clear();
+	int result = Z_OK;
+	while( result == Z_OK )
+	{
+		size_t pos = o_data.size();
+		o_data.resize( pos + GzChunkSize);
+		zs.next_out  = (Bytef*)( &o_data[pos]);
+		zs.avail_out = GzChunkSize;
+
+		result = inflate( &zs, Z_NO_FLUSH);
+		o_data.resize( pos + GzChunkSize - zs.avail_out);
+
+		// Appended output portions are separate gzip members:
+		if(( result == Z_STREAM_END ) && ( zs.avail_in > 0 ) && gzIsCompressed((const char*)( zs.next_in), zs.avail_in))
+			result = inflateReset( &zs);
+
+		if(( i_maxsize > 0 ) && ( o_data.size() >= size_t( i_maxsize)))
+		{
+			o_data.resize( i_maxsize);
+			if( o_err ) *o_err = "Decompressed data size overflow.";
+			break;
+		}
+	}
+	inflateEnd( &zs);
+
+	if(( result != Z_STREAM_END ) && ( result != Z_OK ))
+	{
+		if( o_err ) *o_err = std::string("Data decompression failed: ") + ( zs.msg ? zs.msg : af::itos( result));
+		return false;
+	}
+
+	return true;
+#else
+	if( o_err ) *o_err = "Afanasy was built without zlib, can't decompress data.";
+	return false;
+#endif
+}
+
+char * af::fileReadDecompress( const std::string & i_filename, int * o_size, int i_maxfilesize, std::string * o_err)
+{
+	// Not compressed file is read limited by size, as it was read before compression:
+	char magic[3];
+	int magic_size = 0;
+	FILE * file = fopen( i_filename.c_str(), "rb");
+	if( file )
+	{
+		magic_size = fread( magic, 1, 3, file);
+		fclose( file);
+	}
+	if( false == gzIsCompressed( magic, magic_size))
+		return fileRead( i_filename, o_size, i_maxfilesize, o_err);
+
+	// Compressed data size is limited on decompression:
+	int size = 0;
+	char * data = fileRead( i_filename, &size, -1, o_err);
+	if( data == NULL )
+		return NULL;
+
+	std::string buffer;
+	bool ok = gzDecompress( data, size, buffer, i_maxfilesize, o_err);
+	delete [] data;
+	if( false == ok )
+		return NULL;
+
+	data = new char[buffer.size() + 1];
+	memcpy( data, buffer.data(), buffer.size());
+	data[buffer.size()] = '\0';
+	if( o_size ) *o_size = buffer.size();
+
+	return data;
+}
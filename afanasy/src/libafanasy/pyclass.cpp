@@ -1,5 +1,7 @@
 #include "pyclass.h"
 
+#include <sys/stat.h>
+
 #include "environment.h"
 
 using namespace af;
@@ -24,36 +26,107 @@ PyClass::PyClass():
 {
 }
 
-bool PyClass::init( const std::string & dir, const std::string & name, PyObject * initArgs)
+std::map<std::string, PyClass::Module> PyClass::ms_modules;
+
+void PyClass::ReloadModules()
 {
-   modulename = dir + "." + name;
-   AFINFA("Instancing pyclass '%s'", modulename.c_str())
+   for( std::map<std::string, Module>::iterator it = ms_modules.begin(); it != ms_modules.end(); it++)
+      it->second.reload = true;
+
+   if( ms_modules.size())
+      std::cout << "Python modules will be reloaded: " << ms_modules.size() << std::endl;
+}
+
+time_t PyClass::getFileMTime( const std::string & i_file)
+{
+   if( i_file.empty()) return 0;
+
+   struct stat st;
+   if( stat( i_file.c_str(), &st) != 0 ) return 0;
+
+   return st.st_mtime;
+}
+
+PyClass::Module * PyClass::getModule( const std::string & i_modulename, const std::string & i_name)
+{
+   std::map<std::string, Module>::iterator it = ms_modules.find( i_modulename);
+   if( it != ms_modules.end())
+   {
+      Module & cached = it->second;
+      if(( false == cached.reload ) && ( getFileMTime( cached.file) == cached.mtime ))
+         return &cached;
+
+      // Module changed, it will be reloaded:
+      Py_XDECREF( cached.type);
+      Py_XDECREF( cached.module);
+      ms_modules.erase( it);
+   }
 
    //
    // Load module
-   PyObject * _PyObj_Module_ = PyImport_ImportModule( modulename.c_str());
+   PyObject * _PyObj_Module_ = PyImport_ImportModule( i_modulename.c_str());
    if(_PyObj_Module_== NULL)
    {
       if( PyErr_Occurred()) PyErr_Print();
-      return false;
+      return NULL;
    }
-   // Reload module
-   PyObj_Module = PyImport_ReloadModule(_PyObj_Module_);
-   if( PyObj_Module == NULL)
+   // Reload module, it can be imported before, for example by other module
+   PyObject * module = PyImport_ReloadModule(_PyObj_Module_);
+   Py_DECREF( _PyObj_Module_);
+   if( module == NULL)
    {
       if( PyErr_Occurred()) PyErr_Print();
-      return false;
+      return NULL;
    }
-   Py_DECREF( _PyObj_Module_);
 
    //Get class type
-   PyObj_Type = PyObject_GetAttrString( PyObj_Module, name.c_str());
-   if( PyObj_Type == NULL)
+   PyObject * type = PyObject_GetAttrString( module, i_name.c_str());
+   if( type == NULL)
    {
       if( PyErr_Occurred()) PyErr_Print();
-      return false;
+      Py_DECREF( module);
+      return NULL;
    }
 
+   Module & mod = ms_modules[i_modulename];
+   mod.module = module;
+   mod.type = type;
+   mod.reload = false;
+
+   PyObject * file = PyObject_GetAttrString( module, "__file__");
+   if( file )
+   {
+      af::PyGetString( file, mod.file);
+      Py_DECREF( file);
+   }
+   else
+      PyErr_Clear();
+   mod.mtime = getFileMTime( mod.file);
+
+   if( af::Environment::isVerboseMode())
+      std::cout << "Module \"" << i_modulename << "\" imported." << std::endl;
+
+   return &mod;
+}
+
+bool PyClass::init( const std::string & dir, const std::string & name, PyObject * initArgs)
+{
+   modulename = dir + "." + name;
+   AFINFA("Instancing pyclass '%s'", modulename.c_str())
+
+   Module * mod = getModule( modulename, name);
+   if( mod == NULL )
+      return false;
+
+   // Previous init can fail on instancing
+   if( PyObj_Type   ) Py_XDECREF( PyObj_Type  );
+   if( PyObj_Module ) Py_XDECREF( PyObj_Module);
+
+   PyObj_Module = mod->module;
+   PyObj_Type = mod->type;
+   Py_INCREF( PyObj_Module);
+   Py_INCREF( PyObj_Type);
+
    // Get class instance
 //#if PY_MAJOR_VERSION < 3
 //   PyObj_Instance = PyInstance_New( PyObj_Type, initArgs, NULL);
@@ -66,9 +139,6 @@ bool PyClass::init( const std::string & dir, const std::string & name, PyObject
    }
    if( initArgs) Py_DECREF( initArgs);
 
-    if( af::Environment::isVerboseMode())
-        std::cout << "Module \"" << modulename << "\" imported." << std::endl;
-
    return true;
 }
 
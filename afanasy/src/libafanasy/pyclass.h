@@ -3,6 +3,8 @@
 //#include <Python.h>
 #include "name_af.h"
 
+#include <map>
+
 namespace af
 {
 class PyClass
@@ -14,8 +16,13 @@ public:
    /// Deincrement all objects references ( and functions too )
    ~PyClass();
 
+   /// Forget imported modules, they will be reloaded on the next use.
+   static void ReloadModules();
+
 protected:
-   /// Import and reload module, find and instance class with provided arguments (arguments will be destoyed if not NULL)
+   /// Import module, find and instance class with provided arguments (arguments will be destoyed if not NULL)
+   /** Module and class are imported once per process and cached,
+   *** module is reloaded if its file modification time changed, or after ReloadModules() call. **/
    bool init( const std::string & dir, const std::string & name, PyObject * initArgs);
 
    /// Get function (get attribute by name and check if it callable)
@@ -31,5 +38,24 @@ private:
 
    /// All functions list (stored on "getFunction"), will be deleted in destructor
    std::list<PyObject*> PyObj_FuncList;
+
+private:
+   /// Imported module and class.
+   struct Module
+   {
+      PyObject * module;
+      PyObject * type;
+      std::string file;   ///< Module file, to check its modification time.
+      time_t mtime;
+      bool reload;        ///< Module should be reloaded on the next use.
+   };
+
+   /// Get module and class from cache, or import them.
+   static Module * getModule( const std::string & i_modulename, const std::string & i_name);
+
+   static time_t getFileMTime( const std::string & i_file);
+
+   /// Modules cache: "module.class" -> module and class objects.
+   static std::map<std::string, Module> ms_modules;
 };
 }
@@ -10,10 +10,16 @@ using namespace af;
 
 const int RegExp::compile_flags = REG_EXTENDED;
 
+const size_t RegExp::CacheMaxSize = 256;
+
+std::atomic<int64_t> RegExp::cache_hits( 0);
+std::atomic<int64_t> RegExp::cache_misses( 0);
+
 RegExp::RegExp():
 	contain( false),
 	exclude( false),
-	cflags( RegExp::compile_flags)
+	cflags( RegExp::compile_flags),
+	pattern_cflags( RegExp::compile_flags)
 {
 }
 
@@ -34,6 +40,8 @@ bool RegExp::setPattern( const std::string & str, std::string * strError)
 			regexp = std::regex( pattern, std::regex_constants::icase);
 		else
 			regexp = std::regex( pattern);
+		pattern_cflags = cflags;
+		updateCacheKey();
 		return true;
 	}
 	else
@@ -49,6 +57,7 @@ bool RegExp::setPattern( const std::string & str, std::string * strError)
 			pattern.clear();
 			regfree( &regexp);
 		}
+		updateCacheKey();
 		return true;
 	}
 
@@ -57,6 +66,8 @@ bool RegExp::setPattern( const std::string & str, std::string * strError)
 	if( false == pattern.empty()) regfree( &regexp);
 	pattern = str;
 	regcomp( &regexp, pattern.c_str(), cflags);
+	pattern_cflags = cflags;
+	updateCacheKey();
 	return true;
 
 #endif
@@ -95,9 +106,41 @@ bool RegExp::match( const std::string & str) const
 	return ((retval == 0) != exclude );
 }
 
+void RegExp::updateCacheKey()
+{
+	cache_key.clear();
+	cache_key += ( pattern_cflags & REG_ICASE ) ? 'i' : 's';
+	cache_key += contain ? 'c' : 'm';
+	cache_key += exclude ? 'e' : 'n';
+	cache_key += pattern;
+}
+
+bool RegExp::match( const std::string & str, RegExpCache & io_cache) const
+{
+	// Empty pattern matches anything, there is nothing to cache.
+	if( pattern.empty()) return true;
+
+	std::map<std::string, bool>::const_iterator it = io_cache.m_results.find( cache_key);
+	if( it != io_cache.m_results.end())
+	{
+		cache_hits++;
+		return it->second;
+	}
+
+	cache_misses++;
+	bool result = match( str);
+
+	// Cache is limited not to grow with patterns of all nodes:
+	if( io_cache.m_results.size() >= CacheMaxSize )
+		io_cache.m_results.clear();
+	io_cache.m_results[cache_key] = result;
+
+	return result;
+}
+
 int RegExp::weigh() const
 {
-	return sizeof(RegExp) + af::weigh( pattern);
+	return sizeof(RegExp) + af::weigh( pattern) + af::weigh( cache_key);
 }
 
 bool RegExp::Validate( const std::string & str, std::string * errOutput)
@@ -10,8 +10,26 @@ static const int REG_ICASE = 1;
 
 #include "name_af.h"
 
+#include <atomic>
+#include <map>
+
 namespace af
 {
+/// Cached matches of one string (for example render name) with different patterns.
+/** Patterns are keyed by their text and flags, so equal masks of different nodes share a result.
+*** Owner should clear it when the string changes. Cache is not synchronized. **/
+class RegExpCache
+{
+public:
+	inline void clear() { m_results.clear(); }
+	inline size_t size() const { return m_results.size(); }
+
+private:
+	std::map<std::string, bool> m_results;
+
+	friend class RegExp;
+};
+
 /// POSIX regural expressions class.
 class RegExp
 {
@@ -33,13 +51,21 @@ public:
 	inline void setCaseSensitive()   { cflags = compile_flags; }
 	inline void setCaseInsensitive() { cflags = compile_flags | REG_ICASE; }
 
-	inline void setMatch()   { contain = false; }
-	inline void setContain() { contain = true;  }
-	inline void setInclude() { exclude = false; }
-	inline void setExclude() { exclude = true;  }
+	inline void setMatch()   { contain = false; updateCacheKey(); }
+	inline void setContain() { contain = true;  updateCacheKey(); }
+	inline void setInclude() { exclude = false; updateCacheKey(); }
+	inline void setExclude() { exclude = true;  updateCacheKey(); }
 
 	bool match( const std::string & str) const;
 
+	/// Match with a result cache of the string \c str.
+	/** Cache is limited in size, it is cleared when full. **/
+	bool match( const std::string & str, RegExpCache & io_cache) const;
+
+	/// Cached matches statistics, to check that solving does not spend time on regular expressions.
+	static inline int64_t getCacheHits()   { return cache_hits;   }
+	static inline int64_t getCacheMisses() { return cache_misses; }
+
 	int weigh() const;
 
 private:
@@ -49,6 +75,11 @@ private:
 	bool contain;
 	std::string pattern;
 
+	/// Pattern and flags it was compiled with, to key cached results.
+	int pattern_cflags;
+	std::string cache_key;
+	void updateCacheKey();
+
 #ifdef REGEX_STD
 	std::regex regexp;
 #else
@@ -56,5 +87,12 @@ private:
 #endif
 
 	static const int compile_flags;
+
+	/// Maximum number of patterns results cached for a string.
+	static const size_t CacheMaxSize;
+
+	/// Cached matching is performed by the run thread, counters are read by requests threads.
+	static std::atomic<int64_t> cache_hits;
+	static std::atomic<int64_t> cache_misses;
 };
 }
@@ -0,0 +1,173 @@
+#include "serverconnection.h"
+
+#ifndef WINNT
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define closesocket ::close
+#endif
+
+#include "environment.h"
+#include "msg.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "logger.h"
+
+using namespace af;
+
+// Refused server is asked again after this time, it can be restarted with another config.
+static const int RefusedRetrySec = 60;
+
+ServerConnection::ServerConnection():
+	m_sfd( -1),
+	m_idle_timeout( 0),
+	m_time_used( 0),
+	m_time_refused( 0)
+{
+}
+
+ServerConnection::~ServerConnection()
+{
+	close();
+}
+
+void ServerConnection::close()
+{
+	if( m_sfd < 0 )
+		return;
+
+	closesocket( m_sfd);
+	m_sfd = -1;
+}
+
+Msg * ServerConnection::send( Msg * i_msg, bool & o_ok, VerboseMode i_verbose)
+{
+	o_ok = true;
+
+	time_t now = time( NULL);
+
+	// Server closes idle connection, it is better not to use it near the timeout.
+	if( isOpened() && ( now - m_time_used >= m_idle_timeout - 1 ))
+		close();
+
+	// Server can close connection on restart.
+	if( isOpened() && isClosedByServer())
+		close();
+
+	bool reused = isOpened();
+	if( false == reused )
+	{
+		if( m_time_refused && ( now - m_time_refused < RefusedRetrySec ))
+			return af::sendToServer( i_msg, o_ok, i_verbose);
+
+		if( false == open( i_msg, i_verbose))
+		{
+			if( m_time_refused )
+				return af::sendToServer( i_msg, o_ok, i_verbose);
+
+			o_ok = false;
+			return NULL;
+		}
+	}
+
+	bool written = false;
+	Msg * answer = exchange( i_msg, &written);
+
+	if(( NULL == answer ) && reused && ( false == written ))
+	{
+		// Server closed connection before the message was written,
+		// so the message was not processed and can be sent again.
+		// A written message can be processed already, it is not sent twice.
+		close();
+		if( open( i_msg, i_verbose))
+			answer = exchange( i_msg);
+	}
+
+	if( NULL == answer )
+	{
+		close();
+		o_ok = false;
+		return NULL;
+	}
+
+	m_time_used = time( NULL);
+
+	return answer;
+}
+
+bool ServerConnection::open( const Msg * i_msg, VerboseMode i_verbose)
+{
+	m_sfd = af::connectToAddress( af::Environment::getServerAddress(), i_msg, i_verbose);
+	if( m_sfd < 0 )
+		return false;
+
+	Msg msg( Msg::TKeepAlive);
+	Msg * answer = exchange( &msg);
+
+	if( answer && ( answer->type() == Msg::TKeepAlive ) && ( answer->int32() > 0 ))
+	{
+		m_idle_timeout = answer->int32();
+		m_time_used = time( NULL);
+		m_time_refused = 0;
+		delete answer;
+		return true;
+	}
+
+	if( answer )
+		delete answer;
+
+	AF_LOG << "Server refused to keep connection, connecting for each message.";
+
+	close();
+	m_time_refused = time( NULL);
+
+	return false;
+}
+
+bool ServerConnection::isClosedByServer() const
+{
+#ifndef WINNT
+	// Idle connection has nothing to read, so read would block.
+	// Socket is closed by server if it has end of file, an error or an unexpected data.
+	// (select() can't be used here, as descriptor can be greater than FD_SETSIZE)
+	char c;
+	if( recv( m_sfd, &c, 1, MSG_PEEK | MSG_DONTWAIT) < 0 )
+		if(( errno == EAGAIN ) || ( errno == EWOULDBLOCK ) || ( errno == EINTR ))
+			return false;
+
+	return true;
+#else
+	// Windows sockets set is an array of sockets, not a bit mask, there is no descriptor limit.
+	fd_set fds;
+	FD_ZERO( &fds);
+	FD_SET( m_sfd, &fds);
+	struct timeval tv;
+	tv.tv_sec = 0;
+	tv.tv_usec = 0;
+
+	return select( m_sfd + 1, &fds, NULL, NULL, &tv) != 0;
+#endif
+}
+
+Msg * ServerConnection::exchange( const Msg * i_msg, bool * o_written)
+{
+	if( o_written )
+		*o_written = false;
+
+	if( false == af::msgwrite( m_sfd, i_msg))
+		return NULL;
+
+	if( o_written )
+		*o_written = true;
+
+	Msg * answer = new Msg();
+	if( false == af::msgread( m_sfd, answer))
+	{
+		delete answer;
+		return NULL;
+	}
+
+	return answer;
+}
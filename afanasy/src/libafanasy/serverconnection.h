@@ -0,0 +1,40 @@
+#pragma once
+
+#include "name_af.h"
+
+namespace af
+{
+/// Persistent connection to server.
+/** Messages are sent one by one using the same socket, each message is followed by its answer.
+*** Connection is opened by a TKeepAlive message, server answers with an idle timeout.
+*** If server refuses to keep connection, messages are sent as usual: connection per message. **/
+class ServerConnection
+{
+public:
+	ServerConnection();
+	~ServerConnection();
+
+	/// Send a message and receive an answer, like af::sendToServer().
+	Msg * send( Msg * i_msg, bool & o_ok, VerboseMode i_verbose);
+
+	void close();
+
+	inline bool isOpened() const { return m_sfd >= 0; }
+
+private:
+	bool open( const Msg * i_msg, VerboseMode i_verbose);
+
+	/// Write a message and read an answer, o_written is set when the message was written.
+	Msg * exchange( const Msg * i_msg, bool * o_written = NULL);
+
+	/// Server never sends anything between answers, so a readable socket is closed by server.
+	bool isClosedByServer() const;
+
+private:
+	int m_sfd;
+
+	int m_idle_timeout;   ///< Server closes connection after this time of idle.
+	time_t m_time_used;   ///< Last message time.
+	time_t m_time_refused;///< Server refused to keep connection, asking again after some time.
+};
+}
@@ -8,17 +8,19 @@ using namespace af;
 
 TaskProgress::TaskProgress():
    state(0),
-   percent(0),
+   time_start(0),
+   time_done(0),
    frame(0),
-   percentframe(0),
+   last_percent_change(0),
    starts_count(0),
    errors_count(0),
-   time_start(0),
-   time_done(0)
+   percent(0),
+   percentframe(0)
 {
 }
 
-TaskProgress::TaskProgress( Msg * msg)
+TaskProgress::TaskProgress( Msg * msg):
+   last_percent_change(0)
 {
    read( msg);
 }
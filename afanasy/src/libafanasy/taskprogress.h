@@ -19,20 +19,18 @@ public:
 	
 	virtual int calcWeight() const;
 	
+	// Members read on every progress scan come first, grouped by size without padding,
+	// strings that scans do not read follow them.
+	// Tasks of a block are stored contiguously (see JobProgress), not scattered on heap.
 	int64_t state;         ///< state per block per task.
-	int8_t  percent;       ///< percent per block per task.
-	int64_t frame;         ///< frame per block per task.
-	int8_t  percentframe;  ///< frame percent per block per task.
-	int32_t starts_count;  ///< number of starts per block per task.
-	int32_t errors_count;  ///< Number of times task finished with errors .
 	int64_t time_start;    ///< start time.
 	int64_t time_done;     ///< Task finish time ( or last update time if still running ).
+	int64_t frame;         ///< frame per block per task.
 	int64_t last_percent_change; ///< Time of the last time that `percent` has been changed
-
-	inline void setSolved() { state |= AFJOB::STATE_SOLVED_MASK; }
-	inline void setNotSolved() { state &= (~AFJOB::STATE_SOLVED_MASK); }
-	inline bool isSolved() const { return state & AFJOB::STATE_SOLVED_MASK; }
-	inline bool isNotSolved() const { return false == (state & AFJOB::STATE_SOLVED_MASK); }
+	int32_t starts_count;  ///< number of starts per block per task.
+	int32_t errors_count;  ///< Number of times task finished with errors .
+	int8_t  percent;       ///< percent per block per task.
+	int8_t  percentframe;  ///< frame percent per block per task.
 
 	std::string hostname; ///< Host, last event occurs where.
 	std::string activity; ///< Task activity that was parsed.
@@ -37,6 +37,10 @@ public:
 	inline bool checkHostsMask(         const std::string & str  ) const { return m_hosts_mask.match( str);        }
 	inline bool checkHostsMaskExclude(  const std::string & str  ) const { return m_hosts_mask_exclude.match( str);}
 
+	/// Cached checks, \c cache is a render cache of the \c str matches.
+	inline bool checkHostsMask(         const std::string & str, RegExpCache & cache ) const { return m_hosts_mask.match( str, cache);        }
+	inline bool checkHostsMaskExclude(  const std::string & str, RegExpCache & cache ) const { return m_hosts_mask_exclude.match( str, cache);}
+
 	inline bool setHostsMask(         const std::string & str, std::string * errOutput = NULL)
 		{ return setRegExp( m_hosts_mask, str, "user hosts mask", errOutput);}
 	inline bool setHostsMaskExclude(  const std::string & str, std::string * errOutput = NULL)
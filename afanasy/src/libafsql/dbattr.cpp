@@ -141,6 +141,13 @@ const std::string DBAttr::DBString( const std::string * str) const
 	return dbstr;
 }
 
+const std::string DBAttr::DBValue( const std::string & str) const
+{
+	if(( str.size() > DBLength[type] ) && ( DBLength[type] != 0))
+		return str.substr( 0, DBLength[type]);
+	return str;
+}
+
 DBAttrInt8  ::DBAttrInt8      ( int type,   int8_t * parameter):     DBAttr( type), pointer( parameter) {}
 DBAttrInt8  ::~DBAttrInt8     (){}
 DBAttrUInt8 ::DBAttrUInt8     ( int type,  uint8_t * parameter):     DBAttr( type), pointer( parameter) {}
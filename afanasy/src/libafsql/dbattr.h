@@ -115,6 +115,8 @@ public:
 	};
 
 	virtual const std::string getString() const = 0;
+	/// Value as a statement parameter, not quoted.
+	inline virtual const std::string getValue() const { return getString();}
 	inline virtual void set( long long value) {};
 	inline virtual void set( const std::string & value) {};
 
@@ -126,6 +128,7 @@ public:
 protected:
 	const std::string DBString( const std::string * str) const;
 	inline const std::string DBString( const std::string str)  const { return DBString( &str);}
+	const std::string DBValue( const std::string & str) const;
 
 private:
 	static std::string DBName[_LAST_];
@@ -221,6 +224,7 @@ public:
 	DBAttrString( int type, std::string * parameter);
 	~DBAttrString();
 	inline const std::string getString() const { return DBString( pointer);}
+	inline const std::string getValue() const { return DBValue( *pointer);}
 	inline void set( const std::string & value) { *pointer = value;}
 private: std::string * pointer;
 };
@@ -231,6 +235,7 @@ public:
 	DBAttrRegExp( int type, af::RegExp * parameter);
 	~DBAttrRegExp();
 	inline const std::string getString() const { return DBString( pointer->getPattern());}
+	inline const std::string getValue() const { return DBValue( pointer->getPattern());}
 	inline void set( const std::string & value) { af::setRegExp( *pointer, value, "DBAttrQRegExp::set");}
 private: af::RegExp * pointer;
 };
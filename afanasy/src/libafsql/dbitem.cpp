@@ -55,6 +55,36 @@ void DBItem::v_dbInsert( std::list<std::string> * queries) const
 	queries->push_back( str);
 }
 
+const std::string DBItem::dbInsertStatement( int i_rows) const
+{
+	std::string str = std::string("INSERT INTO ") + v_dbGetTableName() + " (";
+	for( int i = 0; i < dbAttributes.size(); i++)
+	{
+		if( i != 0 ) str += ",";
+		str += dbAttributes[i]->getName();
+	}
+	str += ") VALUES";
+	int param = 1;
+	for( int r = 0; r < i_rows; r++)
+	{
+		str += ( r != 0 ) ? ",(" : " (";
+		for( int i = 0; i < dbAttributes.size(); i++)
+		{
+			if( i != 0 ) str += ",";
+			str += "$" + af::itos( param++);
+		}
+		str += ")";
+	}
+	str += ";";
+	return str;
+}
+
+void DBItem::dbInsertValues( std::vector<std::string> * o_values) const
+{
+	for( int i = 0; i < dbAttributes.size(); i++)
+		o_values->push_back( dbAttributes[i]->getValue());
+}
+
 void DBItem::v_dbDelete( std::list<std::string> * queries) const
 {
  	queries->push_back( std::string("DELETE FROM ") + v_dbGetTableName()
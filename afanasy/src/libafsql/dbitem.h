@@ -16,6 +16,13 @@ public:
 	void dbDropTable(   std::list<std::string> * queries) const;
 
 	virtual void v_dbInsert( std::list<std::string> * queries) const;
+
+	/// Insert statement of several rows with parameters ($1,$2...) for each attribute, to prepare it.
+	const std::string dbInsertStatement( int i_rows) const;
+	/// Append current attributes values, as insert statement parameters.
+	void dbInsertValues( std::vector<std::string> * o_values) const;
+	inline int dbGetAttrsNum() const { return dbAttributes.size();}
+
 	virtual void v_dbDelete( std::list<std::string> * queries) const;
 	virtual void v_dbUpdate( std::list<std::string> * queries, int attr = -1) const;
 	virtual bool v_dbSelect( PGconn * i_conn, const std::string * i_where = NULL);
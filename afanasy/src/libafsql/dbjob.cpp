@@ -30,7 +30,7 @@ DBJob::~DBJob()
 {
 }
 
-void DBJob::add( const af::Job * i_job, std::list<std::string> * o_queries)
+void DBJob::add( const af::Job * i_job, std::vector<std::string> * o_values)
 {
 	// Get job parameters:
 	m_jobname     = i_job->getName();
@@ -67,6 +67,6 @@ void DBJob::add( const af::Job * i_job, std::list<std::string> * o_queries)
 		if( m_run_time_sum == 0 ) continue;
 
 		// Insert row:
-		v_dbInsert( o_queries);
+		dbInsertValues( o_values);
 	}
 }
@@ -12,7 +12,8 @@ public:
 	DBJob();
 	virtual ~DBJob();
 
-	void add( const af::Job * i_job, std::list<std::string> * o_queries);
+	/// Append job blocks rows values to insert.
+	void add( const af::Job * i_job, std::vector<std::string> * o_values);
 
 	inline const std::string & v_dbGetTableName()  const { return ms_TableName;}
 
@@ -38,7 +38,7 @@ void DBTask::add(
 	const af::TaskProgress * i_progress,
 	const af::Job * i_job,
 	const af::Render * i_render,
-	std::list<std::string> * o_queries)
+	std::vector<std::string> * o_values)
 {
 	// Get task exec parameters:
 	m_command   = i_exec->getCommand();
@@ -68,5 +68,5 @@ void DBTask::add(
 	if( m_time_done < m_time_start ) m_time_done = time( NULL);
 
 	// Insert row:
-	v_dbInsert( o_queries);
+	dbInsertValues( o_values);
 }
@@ -12,12 +12,13 @@ public:
 	DBTask();
 	virtual ~DBTask();
 
+	/// Append task run row values to insert.
 	void add(
 		const af::TaskExec * i_exec,
 		const af::TaskProgress * i_progress,
 		const af::Job * i_job,
 		const af::Render * i_render,
-		std::list<std::string> * o_queries);
+		std::vector<std::string> * o_values);
 
 	inline const std::string & v_dbGetTableName()  const { return ms_TableName;}
 
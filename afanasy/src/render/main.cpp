@@ -6,9 +6,11 @@
 
 #include "../libafanasy/environment.h"
 #include "../libafanasy/host.h"
+#include "../libafanasy/pyclass.h"
 #include "../libafanasy/render.h"
 #include "../libafanasy/renderevents.h"
 
+#include "parsernative.h"
 #include "res.h"
 #include "renderhost.h"
 
@@ -76,6 +78,8 @@ int main(int argc, char *argv[])
 	ENV.addUsage( std::string("-cmd") + " [command]", "Run command only, do not connect to server.");
 	ENV.addUsage("-res", "Check host resources only and quit.");
 	ENV.addUsage("-nor", "No output redirection.");
+	ENV.addUsage( std::string("-parsebench") + " [file]", "Replay output log through native and python parsers and quit.");
+	ENV.addUsage( std::string("-parser") + " [name]", "Parser name for parsers benchmark, default is \"generic\".");
 	// Help mode, usage is alredy printed, exiting:
 	if( ENV.isHelpMode() )
 		return 0;
@@ -95,6 +99,17 @@ int main(int argc, char *argv[])
 		return 0;
 	}
 
+	// Benchmark parsers and exit:
+	if( ENV.hasArgument("-parsebench"))
+	{
+		std::string file, parser("generic");
+		ENV.getArgument("-parsebench", file);
+		ENV.getArgument("-parser", parser);
+		int status = ParserBenchmark( parser, file);
+		Py_Finalize();
+		return status;
+	}
+
 	// Run command and exit
 	if( ENV.hasArgument("-cmd"))
 	{
@@ -161,9 +176,23 @@ int main(int argc, char *argv[])
 		printf("=============================================================\n\n");
 		#endif
 
+		if( false == AFRunning )
+			break;
+
+		// Wait for server events till the next heartbeat,
+		// new tasks are received just after server solving:
+		if( af::Environment::getRenderEventsWait() && render->isConnected())
+		{
+			answer = render->waitServerEvents();
+			if( answer )
+			{
+				msgCase( answer, *render);
+				continue;
+			}
+		}
+
 		// Sleep till the next heartbeat:
-		if( AFRunning )
-			af::sleep_sec( af::Environment::getRenderHeartbeatSec());
+		af::sleep_sec( af::Environment::getRenderHeartbeatSec());
 	}
 
 	delete render;
@@ -295,6 +324,11 @@ AF_LOG << i_re;
 			AF_LOG << "Render sleep request received.";
 			i_render.wolSleep( i_re.m_command);
 		}
+		else if( i_re.m_instruction == "reload_python")
+		{
+			AF_LOG << "Python modules reload request received.";
+			af::PyClass::ReloadModules();
+		}
 		else if( i_re.m_instruction == "launch")
 		{
 			launchAndExit( i_re.m_command, false);
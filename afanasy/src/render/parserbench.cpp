@@ -0,0 +1,156 @@
+#include "parsernative.h"
+
+#include <ctime>
+
+#include "../libafanasy/service.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+namespace
+{
+/// Output portion size, as task process reads it from a pipe.
+const int ChunkSize = 4096;
+
+/// Process CPU time in milliseconds.
+long long cpuMSec() { return ( long long)( clock()) * 1000 / CLOCKS_PER_SEC; }
+
+/// Parser state after an output portion.
+struct State
+{
+	int percent;
+	int frame;
+	int percentframe;
+	std::string activity;
+	std::string report;
+	bool warning;
+	bool error;
+	bool badresult;
+	bool finishedsuccess;
+
+	bool operator==( const State & i_other) const
+	{
+		return ( percent == i_other.percent ) && ( frame == i_other.frame ) && ( percentframe == i_other.percentframe ) &&
+			( activity == i_other.activity ) && ( report == i_other.report ) &&
+			( warning == i_other.warning ) && ( error == i_other.error ) &&
+			( badresult == i_other.badresult ) && ( finishedsuccess == i_other.finishedsuccess );
+	}
+
+	void print() const
+	{
+		printf("percent=%d frame=%d percentframe=%d activity=\"%s\" report=\"%s\"%s%s%s%s\n",
+			percent, frame, percentframe, activity.c_str(), report.c_str(),
+			warning ? " WARNING" : "", error ? " ERROR" : "",
+			badresult ? " BAD_RESULT" : "", finishedsuccess ? " FINISHED_SUCCESS" : "");
+	}
+};
+}
+
+int ParserBenchmark( const std::string & i_parser, const std::string & i_file)
+{
+	int size = 0;
+	std::string err;
+	char * data = af::fileRead( i_file, &size, -1, &err);
+	if( data == NULL )
+	{
+		AF_ERR << err;
+		return 1;
+	}
+
+	std::vector<std::string> chunks;
+	for( int pos = 0; pos < size; pos += ChunkSize)
+		chunks.push_back( std::string( data + pos, std::min( ChunkSize, size - pos)));
+	delete [] data;
+
+	ParserNative * native = ParserNative::create( i_parser, 1);
+	if( native == NULL )
+	{
+		AF_ERR << "No native parser \"" << i_parser << "\".";
+		return 1;
+	}
+
+	af::Service service("generic", i_parser);
+	if(( false == service.isInitialized()) || ( false == service.hasParser()))
+	{
+		AF_ERR << "Python parser \"" << i_parser << "\" initialization failed.";
+		delete native;
+		return 1;
+	}
+
+	printf("Parser \"%s\", log \"%s\": %d bytes, %d portions of %d bytes.\n",
+		i_parser.c_str(), i_file.c_str(), size, int( chunks.size()), ChunkSize);
+
+	// Python parser:
+	std::vector<State> py_states( chunks.size());
+	State state;
+	state.percent = state.frame = state.percentframe = 0;
+	long long time_start = cpuMSec();
+	for( int c = 0; c < chunks.size(); c++)
+	{
+		std::string chunk( chunks[c]);
+		state.warning = state.error = state.badresult = state.finishedsuccess = false;
+		service.parse("", chunk, state.percent, state.frame, state.percentframe,
+			state.activity, state.report, state.warning, state.error, state.badresult, state.finishedsuccess);
+		py_states[c] = state;
+	}
+	long long time_py = cpuMSec() - time_start;
+
+	// Native parser:
+	std::vector<State> na_states( chunks.size());
+	int python_calls = 0;
+	time_start = cpuMSec();
+	for( int c = 0; c < chunks.size(); c++)
+	{
+		std::string python_lines;
+		native->parse( chunks[c], python_lines);
+		if( python_lines.size())
+			python_calls++;
+
+		State & s = na_states[c];
+		s.percent         = native->getPercent();
+		s.frame           = native->getFrame();
+		s.percentframe    = native->getPercentFrame();
+		s.activity        = native->getActivity();
+		s.report          = native->getReport();
+		s.warning         = native->hasWarning();
+		s.error           = native->hasError();
+		s.badresult       = native->isBadResult();
+		s.finishedsuccess = native->isFinishedSuccess();
+	}
+	long long time_na = cpuMSec() - time_start;
+
+	// Compare results:
+	int mismatches = 0;
+	for( int c = 0; c < chunks.size(); c++)
+	{
+		if( py_states[c] == na_states[c])
+			continue;
+
+		if( mismatches < 10 )
+		{
+			printf("Mismatch at portion #%d:\n python: ", c);
+			py_states[c].print();
+			printf(" native: ");
+			na_states[c].print();
+		}
+		mismatches++;
+	}
+
+	if( chunks.size())
+	{
+		printf("Final: ");
+		na_states.back().print();
+	}
+
+	printf("CPU time: python %lld ms, native %lld ms", time_py, time_na);
+	if( time_na > 0 )
+		printf(" (x%.1f)", double( time_py) / double( time_na));
+	printf(", portions with images for python: %d\n", python_calls);
+	printf("Mismatches: %d\n", mismatches);
+
+	delete native;
+
+	return mismatches ? 1 : 0;
+}
@@ -1,6 +1,10 @@
 #include "parserhost.h"
 
+#include "../libafanasy/environment.h"
 #include "../libafanasy/service.h"
+#include "../libafanasy/taskexec.h"
+
+#include "parsernative.h"
 
 #ifdef WINNT
 //#define strcpy strcpy_s
@@ -36,8 +40,9 @@ Maximum size reached. Output middle trunctated.\n\
 \n\
 ";
 
-ParserHost::ParserHost( af::Service * i_service):
+ParserHost::ParserHost( af::Service * i_service, const af::TaskExec * i_taskexec):
 	m_service( i_service),
+	m_native( NULL),
 	m_percent( 0),
 	m_frame( 0),
 	m_percentframe( 0),
@@ -47,7 +52,10 @@ ParserHost::ParserHost( af::Service * i_service):
 	m_finishedsuccess( false),
 	m_data( NULL),
 	m_datasize( 0),
-	m_overload( false)
+	m_overload( false),
+	m_streaming( false),
+	m_stream_stopped( false),
+	m_stream_offset( 0)
 {
 	m_data = new char[ms_DataSizeMax];
 	m_overload_string_length = int(strlen(ms_overload_string));
@@ -57,17 +65,24 @@ ParserHost::ParserHost( af::Service * i_service):
 		AFERROR("ParserHost::ParserHost(): Can`t allocate memory for data.")
 		return;
 	}
+
+	if( i_taskexec && af::Environment::getRenderParsersNative())
+		m_native = ParserNative::create( i_taskexec->getParserType(), i_taskexec->getFramesNum());
 }
 
 ParserHost::~ParserHost()
 {
 	if( m_data != NULL) delete [] m_data;
+	if( m_native != NULL) delete m_native;
 }
 
 void ParserHost::read( const std::string & i_mode, std::string & output)
 {
 	parse( i_mode, output);
 
+	if( m_streaming )
+		m_stream += output;
+
 	// writing output in buffer:
 	//
 	const char * copy_data = output.data();
@@ -140,6 +155,15 @@ printf("\"");for(int c=0;c<out_size;c++)if(copy_size[c]>=32)printf("%c", copy_si
 //printf("Copying overload string.\n");
 			strncpy( m_data+ms_DataSizeHalf-m_overload_string_length, ms_overload_string, m_overload_string_length);
 			m_overload = true;
+
+			// Streamed output can't be cut in the middle,
+			// so server will get the whole output:
+			if( m_streaming )
+			{
+				m_streaming = false;
+				m_stream_stopped = true;
+				m_stream.clear();
+			}
 		}
 
 	}
@@ -162,6 +186,24 @@ fflush( stdout);
 //printf("end: datasize = %d\n", datasize);
 }
 
+void ParserHost::takeStream( int i_max, std::string & o_data, int64_t & o_offset)
+{
+	o_offset = m_stream_offset;
+
+	if(( i_max < 0 ) || ( i_max >= m_stream.size()))
+	{
+		o_data.swap( m_stream);
+		m_stream.clear();
+	}
+	else
+	{
+		o_data = m_stream.substr( 0, i_max);
+		m_stream.erase( 0, i_max);
+	}
+
+	m_stream_offset += o_data.size();
+}
+
 void ParserHost::parse( const std::string & i_mode, std::string & output)
 {
 	bool _warning         = false;
@@ -169,9 +211,36 @@ void ParserHost::parse( const std::string & i_mode, std::string & output)
 	bool _badresult       = false;
 	bool _finishedsuccess = false;
 
-	m_service->parse( i_mode, output, m_percent, m_frame, m_percentframe,
-		m_activity, m_report,
-		_warning, _error, _badresult, _finishedsuccess);
+	if( m_native )
+	{
+		std::string python_lines;
+		m_native->parse( output, python_lines);
+
+		// Python parser collects images and generates thumbnails.
+		if( python_lines.size())
+		{
+			int percent, frame, percentframe;
+			std::string activity, report;
+			bool warning, error, badresult, finishedsuccess;
+			m_service->parse( i_mode, python_lines, percent, frame, percentframe,
+				activity, report, warning, error, badresult, finishedsuccess);
+		}
+
+		m_percent      = m_native->getPercent();
+		m_frame        = m_native->getFrame();
+		m_percentframe = m_native->getPercentFrame();
+		m_activity     = m_native->getActivity();
+		m_report       = m_native->getReport();
+
+		_warning         = m_native->hasWarning();
+		_error           = m_native->hasError();
+		_badresult       = m_native->isBadResult();
+		_finishedsuccess = m_native->isFinishedSuccess();
+	}
+	else
+		m_service->parse( i_mode, output, m_percent, m_frame, m_percentframe,
+			m_activity, m_report,
+			_warning, _error, _badresult, _finishedsuccess);
 
 	if ( _error           ) m_error           = true;
 	if ( _warning         ) m_warning         = true;
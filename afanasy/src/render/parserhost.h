@@ -4,12 +4,14 @@
 
 #include "../libafanasy/name_af.h"
 
+class ParserNative;
+
 class ParserHost
 {
 
 public:
 
-	ParserHost( af::Service * i_service);
+	ParserHost( af::Service * i_service, const af::TaskExec * i_taskexec = NULL);
 	~ParserHost();
 
 	void read( const std::string & i_mode, std::string & output);
@@ -25,8 +27,25 @@ public:
 	inline std::string getReport()    const { return m_report;          }
 	inline char* getData( int *size ) const { *size = m_datasize; return m_data;}
 
+	/// Output is streamed to server in portions, while it is not overloaded.
+	inline void setStreaming() { m_streaming = true; }
+	inline bool isStreaming() const { return m_streaming; }
+	inline int getStreamSize() const { return m_stream.size(); }
+
+	/// Streaming was stopped by output overload, server needs the whole output once.
+	inline bool isStreamStopped() const { return m_stream_stopped; }
+	inline void resetStreamStopped() { m_stream_stopped = false; }
+
+	/// Take not yet streamed output, no more than i_max bytes if it is not negative.
+	/** o_offset is an output stream offset of taken data. **/
+	void takeStream( int i_max, std::string & o_data, int64_t & o_offset);
+
+	/// Get not yet streamed output without taking it.
+	inline void getStream( std::string & o_data, int64_t & o_offset) const { o_data = m_stream; o_offset = m_stream_offset; }
+
 private:
 	af::Service * m_service;
+	ParserNative * m_native; ///< Compiled parser, python parser is used if it is NULL.
 
 	int  m_percent;
 	int  m_frame;
@@ -47,6 +66,11 @@ private:
 	static const char* ms_overload_string;
 	int                m_overload_string_length;
 
+	bool               m_streaming;
+	bool               m_stream_stopped;
+	std::string        m_stream;        ///< Output that is not streamed yet.
+	int64_t            m_stream_offset; ///< Output stream offset of m_stream begin.
+
 private:
 	void parse( const std::string & i_mode, std::string & output);
 };
@@ -0,0 +1,584 @@
+#include "parsernative.h"
+
+#include <stdlib.h>
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+ParserNative::ParserNative( int i_frames_num):
+	m_percent( 0),
+	m_frame( 0),
+	m_percentframe( 0),
+	m_numframes( i_frames_num),
+	m_warning( false),
+	m_error( false),
+	m_badresult( false),
+	m_finishedsuccess( false)
+{
+	if( m_numframes < 1 )
+		m_numframes = 1;
+
+	addFileMarker("@IMAGE@");
+	addFileMarker("@IMAGE!@");
+	addFileMarker("Image: ");
+}
+
+ParserNative::~ParserNative()
+{
+}
+
+void ParserNative::parse( const std::string & i_data, std::string & o_python_lines)
+{
+	if( i_data.size())
+		baseCheck( i_data, o_python_lines);
+
+	v_do( i_data);
+}
+
+static std::string toLower( const std::string & i_str)
+{
+	std::string str( i_str);
+	for( size_t i = 0; i < str.size(); i++)
+		if(( str[i] >= 'A' ) && ( str[i] <= 'Z' ))
+			str[i] = str[i] - 'A' + 'a';
+	return str;
+}
+
+static bool findLower( const std::string & i_lower, const std::vector<std::string> & i_strings)
+{
+	for( int i = 0; i < i_strings.size(); i++)
+		if( i_lower.find( toLower( i_strings[i])) != std::string::npos )
+			return true;
+	return false;
+}
+
+void ParserNative::baseCheck( const std::string & i_data, std::string & o_python_lines)
+{
+	m_activity.clear();
+	m_report.clear();
+	m_warning = false;
+	m_error = false;
+	m_badresult = false;
+
+	if( m_str_warning.size() || m_str_error.size() || m_str_badresult.size() || m_str_finishedsuccess.size())
+	{
+		std::string lower = toLower( i_data);
+		if( findLower( lower, m_str_warning         )) m_warning         = true;
+		if( findLower( lower, m_str_error           )) m_error           = true;
+		if( findLower( lower, m_str_badresult       )) m_badresult       = true;
+		if( findLower( lower, m_str_finishedsuccess )) m_finishedsuccess = true;
+	}
+
+	// Most of output portions do not contain images, lines are not split for them.
+	bool has_files = false;
+	for( int m = 0; m < m_file_markers.size(); m++)
+		if( i_data.find( m_file_markers[m]) != std::string::npos )
+		{
+			has_files = true;
+			break;
+		}
+	if( false == has_files )
+		return;
+
+	std::vector<std::string> lines;
+	splitLines( i_data, lines);
+	for( int l = 0; l < lines.size(); l++)
+	{
+		const std::string & line = lines[l];
+
+		bool is_file = false;
+		for( int m = 0; m < m_file_markers.size(); m++)
+			if( line.find( m_file_markers[m]) != std::string::npos )
+			{
+				is_file = true;
+				break;
+			}
+		if( false == is_file )
+			continue;
+
+		o_python_lines += line + "\n";
+
+		// ImageMagick output counts frames:
+		if(( line.find("@IMAGE@") == std::string::npos ) && ( line.find("Image: ") == 0 ))
+		{
+			m_frame++;
+			calculate();
+		}
+	}
+}
+
+void ParserNative::calculate()
+{
+	if( m_frame < 0 ) m_frame = 0;
+	if( m_frame > m_numframes ) m_frame = m_numframes;
+	if( m_percentframe < 0 ) m_percentframe = 0;
+	if( m_percentframe > 100 ) m_percentframe = 100;
+
+	if( m_numframes > 1 )
+		m_percent = int(( 100.0 * m_frame + m_percentframe ) / m_numframes );
+	else
+		m_percent = m_percentframe;
+
+	if( m_percent < 0 ) m_percent = 0;
+	if( m_percent > 100 ) m_percent = 100;
+}
+
+std::string ParserNative::substrTill( const std::string & i_data, size_t i_pos, char i_char)
+{
+	size_t end = i_data.find( i_char, i_pos);
+	if( end == std::string::npos )
+	{
+		// Python slice with -1 end drops the last character.
+		if( i_data.size() == 0 )
+			return std::string();
+		end = i_data.size() - 1;
+		while(( end > 0 ) && (( i_data[end] & 0xC0 ) == 0x80 ))
+			end--;
+	}
+	if( end <= i_pos )
+		return std::string();
+	return i_data.substr( i_pos, end - i_pos);
+}
+
+static std::string strip( const std::string & i_str)
+{
+	size_t begin = 0, end = i_str.size();
+	while(( begin < end ) && isspace((unsigned char)( i_str[begin]))) begin++;
+	while(( end > begin ) && isspace((unsigned char)( i_str[end-1]))) end--;
+	return i_str.substr( begin, end - begin);
+}
+
+bool ParserNative::toInt( const std::string & i_str, int & o_value)
+{
+	std::string str = strip( i_str);
+	if( str.empty())
+		return false;
+
+	size_t i = 0;
+	bool negative = false;
+	if(( str[0] == '-' ) || ( str[0] == '+' ))
+	{
+		negative = str[0] == '-';
+		i++;
+	}
+	if( i == str.size())
+		return false;
+
+	int64_t value = 0;
+	for( ; i < str.size(); i++)
+	{
+		// Python allows single underscores between digits.
+		if(( str[i] == '_' ) && ( i + 1 < str.size()) && isdigit((unsigned char)( str[i-1])) && isdigit((unsigned char)( str[i+1])))
+			continue;
+		if( false == isdigit((unsigned char)( str[i])))
+			return false;
+		value = value * 10 + ( str[i] - '0');
+		if( value > 0x7fffffff )
+			return false;
+	}
+
+	o_value = int( negative ? -value : value);
+	return true;
+}
+
+bool ParserNative::floatToInt( const std::string & i_str, int & o_value)
+{
+	std::string str = strip( i_str);
+	if( str.empty())
+		return false;
+
+	// strtod also reads hexadecimal, infinity and nan, python int(float()) fails on them.
+	for( size_t i = 0; i < str.size(); i++)
+		if( false == ( isdigit((unsigned char)( str[i])) || ( str[i] == '.' ) || ( str[i] == '-' ) || ( str[i] == '+' ) || ( str[i] == 'e' ) || ( str[i] == 'E' )))
+			return false;
+
+	char * end = NULL;
+	double value = strtod( str.c_str(), &end);
+	if(( end == NULL ) || ( *end != '\0' ))
+		return false;
+	if(( value > 2147483647.0 ) || ( value < -2147483648.0 ))
+		return false;
+
+	o_value = int( value);
+	return true;
+}
+
+void ParserNative::splitLines( const std::string & i_data, std::vector<std::string> & o_lines)
+{
+	size_t pos = 0;
+	for(;;)
+	{
+		size_t end = i_data.find('\n', pos);
+		if( end == std::string::npos )
+		{
+			o_lines.push_back( i_data.substr( pos));
+			break;
+		}
+		o_lines.push_back( i_data.substr( pos, end - pos));
+		pos = end + 1;
+	}
+}
+
+//################################## Parsers: ##################################
+
+/// Simple generic parser.
+class ParserGeneric : public ParserNative
+{
+public:
+	ParserGeneric( int i_frames_num): ParserNative( i_frames_num), m_firstframe( true)
+	{
+		m_str_warning.push_back("[ PARSER WARNING ]");
+		m_str_error.push_back("[ PARSER ERROR ]");
+		m_str_badresult.push_back("[ PARSER BAD RESULT ]");
+		m_str_finishedsuccess.push_back("[ PARSER FINISHED SUCCESS ]");
+	}
+
+protected:
+	bool v_do( const std::string & i_data)
+	{
+		static const std::string FRAME    = "FRAME: ";
+		static const std::string PERCENT  = "PROGRESS: ";
+		static const std::string ACTIVITY = "ACTIVITY: ";
+		static const std::string REPORT   = "REPORT: ";
+
+		bool needcalc = false;
+
+		if( i_data.rfind( FRAME) != std::string::npos )
+		{
+			if( m_firstframe )
+				m_firstframe = false;
+			else
+			{
+				m_frame++;
+				needcalc = true;
+			}
+		}
+
+		size_t percent_pos = i_data.rfind( PERCENT);
+		if( percent_pos != std::string::npos )
+		{
+			percent_pos += PERCENT.size();
+			size_t ppos = i_data.find('%', percent_pos);
+			if( ppos != std::string::npos )
+			{
+				needcalc = true;
+				if( false == toInt( i_data.substr( percent_pos, ppos - percent_pos), m_percentframe))
+					return false;
+			}
+		}
+
+		size_t activity_pos = i_data.rfind( ACTIVITY);
+		if( activity_pos != std::string::npos )
+			m_activity = substrTill( i_data, activity_pos + ACTIVITY.size(), '\n');
+
+		size_t report_pos = i_data.rfind( REPORT);
+		if( report_pos != std::string::npos )
+			m_report = substrTill( i_data, report_pos + REPORT.size(), '\n');
+
+		if( needcalc )
+			calculate();
+
+		return true;
+	}
+
+private:
+	bool m_firstframe;
+};
+
+/// Arnold.
+class ParserArnold : public ParserNative
+{
+public:
+	ParserArnold( int i_frames_num): ParserNative( i_frames_num) {}
+
+protected:
+	bool v_do( const std::string & i_data)
+	{
+		if( i_data.empty())
+			return true;
+
+		// Python: re.findall(r'(\s*)(\d*)(\s*% done)') and the last match digits.
+		size_t pos = i_data.rfind("% done");
+		if( pos == std::string::npos )
+			return true;
+
+		while(( pos > 0 ) && isspace((unsigned char)( i_data[pos-1]))) pos--;
+		size_t end = pos;
+		while(( pos > 0 ) && isdigit((unsigned char)( i_data[pos-1]))) pos--;
+
+		return floatToInt( i_data.substr( pos, end - pos), m_percent);
+	}
+};
+
+/// VRay Standalone.
+class ParserVRay : public ParserNative
+{
+public:
+	ParserVRay( int i_frames_num): ParserNative( i_frames_num)
+	{
+		addFileMarker("Successfully written image file ");
+	}
+
+protected:
+	bool v_do( const std::string & i_data)
+	{
+		static const std::string KEY = "Rendering image";
+
+		if( i_data.empty())
+			return true;
+
+		if( i_data.find( KEY) == std::string::npos )
+			return true;
+
+		// Python: re.findall(r'Rendering image...:([ ]{,})([0-9]{1,2}.*)(%[ ]{,}).*') and the last match.
+		std::string percent;
+		bool found = false;
+		std::vector<std::string> lines;
+		splitLines( i_data, lines);
+		for( int l = 0; l < lines.size(); l++)
+		{
+			const std::string & line = lines[l];
+			size_t pos = line.find( KEY);
+			while( pos != std::string::npos )
+			{
+				size_t p = pos + KEY.size() + 3;
+				if(( p < line.size()) && ( line[p] == ':' ))
+				{
+					p++;
+					while(( p < line.size()) && ( line[p] == ' ' )) p++;
+					size_t pct = line.rfind('%');
+					if(( p < line.size()) && isdigit((unsigned char)( line[p])) && ( pct != std::string::npos ) && ( pct > p ))
+					{
+						percent = line.substr( p, pct - p);
+						found = true;
+						break;
+					}
+				}
+				pos = line.find( KEY, pos + 1);
+			}
+		}
+
+		if( false == found )
+			return true;
+
+		return floatToInt( percent, m_percent);
+	}
+};
+
+/// Blender Batch.
+class ParserBlender : public ParserNative
+{
+public:
+	ParserBlender( int i_frames_num): ParserNative( i_frames_num),
+		m_firstframe( true),
+		m_framestring("Fra:")
+	{
+		m_str_error.push_back("Warning: Unable to open");
+		m_str_error.push_back("Render error: cannot save");
+		m_str_error.push_back("Error: CUDA error");
+
+		addFileMarker("Saved: ");
+	}
+
+protected:
+	bool v_do( const std::string & i_data)
+	{
+		if( i_data.find("Fra:") == std::string::npos )
+			return true;
+
+		std::vector<std::string> lines;
+		splitLines( i_data, lines);
+		bool need_calc = false;
+
+		for( int l = 0; l < lines.size(); l++)
+		{
+			const std::string & line = lines[l];
+
+			if( line.find("Saved: ") != std::string::npos )
+				continue;
+
+			if( line.find("Fra:") == std::string::npos )
+				continue;
+
+			size_t frmpos = line.find(' ');
+			if( frmpos == std::string::npos )
+				continue;
+
+			// Increment frame if new:
+			if( line.compare( 0, frmpos, m_framestring) != 0 )
+			{
+				m_framestring = line.substr( 0, frmpos);
+				need_calc = true;
+				if( m_firstframe )
+					m_firstframe = false;
+				else
+				{
+					m_frame++;
+					m_percentframe = 0;
+				}
+			}
+		}
+
+		if( need_calc )
+			calculate();
+
+		return true;
+	}
+
+private:
+	bool m_firstframe;
+	std::string m_framestring;
+};
+
+/// Blender Cycles.
+class ParserBlenderCycles : public ParserBlender
+{
+public:
+	ParserBlenderCycles( int i_frames_num): ParserBlender( i_frames_num) {}
+
+protected:
+	bool v_do( const std::string & i_data)
+	{
+		static const std::string KEY = "Path Tracing Tile ";
+
+		bool need_calc = false;
+
+		if( i_data.find( KEY) != std::string::npos )
+		{
+			std::vector<std::string> lines;
+			splitLines( i_data, lines);
+			for( int l = 0; l < lines.size(); l++)
+			{
+				const std::string & line = lines[l];
+				size_t ptpos = line.find( KEY);
+				if(( ptpos == std::string::npos ) || ( ptpos == 0 ))
+					continue;
+
+				// Python: line[ptpos+len(keypart):].split(',')[0].split('/')
+				std::string tile = line.substr( ptpos + KEY.size());
+				tile = tile.substr( 0, tile.find(','));
+				size_t slash = tile.find('/');
+				if( slash == std::string::npos )
+					return false;
+				if( tile.find('/', slash + 1) != std::string::npos )
+					continue;
+
+				int part0, part1;
+				if( false == toInt( tile.substr( 0, slash), part0)) continue;
+				if( false == toInt( tile.substr( slash + 1), part1)) continue;
+				if( part1 > 0 )
+				{
+					m_percentframe = int( 100.0 * part0 / part1);
+					need_calc = true;
+				}
+			}
+		}
+
+		if( need_calc )
+			calculate();
+
+		return ParserBlender::v_do( i_data);
+	}
+};
+
+/// The Foundry Nuke.
+class ParserNuke : public ParserNative
+{
+public:
+	ParserNuke( int i_frames_num): ParserNative( i_frames_num)
+	{
+		m_str_error.push_back("Worker process failed");
+	}
+
+protected:
+	bool v_do( const std::string & i_data)
+	{
+		static const std::string KEY = "Writing";
+		static const std::string VIEW = "EXECUTING VIEW \"";
+
+		size_t data_len = i_data.size();
+		if( data_len < 1 )
+			return true;
+
+		if( hasLicenseError( i_data))
+			m_error = true;
+
+		bool needcalc = false;
+
+		size_t key_pos = i_data.find( KEY);
+		if( key_pos != std::string::npos )
+		{
+			size_t file_begin = key_pos + KEY.size() + 1;
+			size_t file_end = i_data.find(' ', file_begin);
+			if(( file_end != std::string::npos ) && ( file_end > 1 ))
+			{
+				std::string newfilename = i_data.substr( file_begin, file_end - file_begin);
+				if( newfilename.size() && ( m_filename != newfilename ))
+				{
+					if( m_filename.size())
+					{
+						m_frame++;
+						m_percentframe = 0;
+						needcalc = true;
+					}
+					m_filename = newfilename;
+				}
+			}
+		}
+
+		if(( data_len >= 2 ) && ( i_data[data_len-2] == '.' ))
+		{
+			char c = i_data[data_len-1];
+			if(( c >= '0' ) && ( c <= '9' ))
+			{
+				m_percentframe = ( c - '0' ) * 10;
+				needcalc = true;
+			}
+		}
+
+		size_t activity_pos = i_data.rfind( VIEW);
+		if( activity_pos != std::string::npos )
+			m_activity = substrTill( i_data, activity_pos + VIEW.size(), '"');
+
+		if( needcalc )
+			calculate();
+
+		return true;
+	}
+
+private:
+	/// Python: re.compile(r'Invalid .* license key.').search(data)
+	static bool hasLicenseError( const std::string & i_data)
+	{
+		size_t pos = i_data.find("Invalid ");
+		while( pos != std::string::npos )
+		{
+			size_t eol = i_data.find('\n', pos);
+			if( eol == std::string::npos )
+				eol = i_data.size();
+
+			size_t key = i_data.find(" license key", pos + 8);
+			if(( key != std::string::npos ) && ( key + 12 < eol ))
+				return true;
+
+			pos = i_data.find("Invalid ", pos + 1);
+		}
+		return false;
+	}
+
+private:
+	std::string m_filename;
+};
+
+ParserNative * ParserNative::create( const std::string & i_name, int i_frames_num)
+{
+	if( i_name == "generic"        ) return new ParserGeneric(       i_frames_num);
+	if( i_name == "arnold"         ) return new ParserArnold(        i_frames_num);
+	if( i_name == "vray"           ) return new ParserVRay(          i_frames_num);
+	if( i_name == "blender"        ) return new ParserBlender(       i_frames_num);
+	if( i_name == "blender_cycles" ) return new ParserBlenderCycles( i_frames_num);
+	if( i_name == "nuke"           ) return new ParserNuke(          i_frames_num);
+	return NULL;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../libafanasy/name_af.h"
+
+/// Compiled task output parser.
+/** It does the same as python parser with the same name (afanasy/python/parsers),
+*** but without python calls for each output portion.
+*** Python parser is still called for lines with images, to collect task files and generate thumbnails. **/
+class ParserNative
+{
+public:
+	virtual ~ParserNative();
+
+	/// Create parser by name, returns NULL if there is no native parser with such name.
+	static ParserNative * create( const std::string & i_name, int i_frames_num);
+
+	/// Parse output portion, like python parser.parse().
+	/** Lines that python parser should process too are stored in o_python_lines. **/
+	void parse( const std::string & i_data, std::string & o_python_lines);
+
+	inline int getPercent()      const { return m_percent;      }
+	inline int getFrame()        const { return m_frame;        }
+	inline int getPercentFrame() const { return m_percentframe; }
+	inline bool hasWarning()         const { return m_warning;         }
+	inline bool hasError()           const { return m_error;           }
+	inline bool isBadResult()        const { return m_badresult;       }
+	inline bool isFinishedSuccess()  const { return m_finishedsuccess; }
+	inline const std::string & getActivity() const { return m_activity; }
+	inline const std::string & getReport()   const { return m_report;   }
+
+protected:
+	ParserNative( int i_frames_num);
+
+	/// Parser specific output processing, like python parser.do().
+	/** Returns false on error, where python parser raises an exception. **/
+	virtual bool v_do( const std::string & i_data) = 0;
+
+	/// Calculate percent from frame and frame percent.
+	void calculate();
+
+	/// Output line marker, which means that line contains an image path.
+	inline void addFileMarker( const char * i_marker) { m_file_markers.push_back( i_marker); }
+
+	/// Get a substring from position till the character, like python data[pos:data.find(char,pos)].
+	static std::string substrTill( const std::string & i_data, size_t i_pos, char i_char);
+
+	/// Convert string to integer like python int(), returns false on error.
+	static bool toInt( const std::string & i_str, int & o_value);
+
+	/// Convert string to integer like python int(float()), returns false on error.
+	static bool floatToInt( const std::string & i_str, int & o_value);
+
+	/// Split data by new lines, like python data.split('\n').
+	static void splitLines( const std::string & i_data, std::vector<std::string> & o_lines);
+
+protected:
+	int m_percent;
+	int m_frame;
+	int m_percentframe;
+	int m_numframes;
+
+	bool m_warning;
+	bool m_error;
+	bool m_badresult;
+	bool m_finishedsuccess;
+
+	std::string m_activity;
+	std::string m_report;
+
+	std::vector<std::string> m_str_warning;
+	std::vector<std::string> m_str_error;
+	std::vector<std::string> m_str_badresult;
+	std::vector<std::string> m_str_finishedsuccess;
+
+private:
+	/// Base check for all parsers, like python parser.doBaseCheck().
+	void baseCheck( const std::string & i_data, std::string & o_python_lines);
+
+private:
+	std::vector<const char *> m_file_markers;
+};
+
+/// Replay output log file through native and python parsers, compare results and time.
+int ParserBenchmark( const std::string & i_parser, const std::string & i_file);
@@ -23,10 +23,15 @@ RenderHost::RenderHost():
 	m_updateMsgType( af::Msg::TRenderRegister),
 	m_connected( false),
 	m_connection_lost_count( 0),
-	m_no_output_redirection( false)
+	m_server_connection( NULL),
+	m_no_output_redirection( false),
+	m_output_budget( 0)
 {
 	m_has_tasks_time = time(NULL);
 
+	if( af::Environment::getRenderServerConnectionKeep())
+		m_server_connection = new af::ServerConnection();
+
 	if( af::Environment::hasArgument("-nor")) m_no_output_redirection = true;
 
     setOnline();
@@ -75,11 +80,14 @@ RenderHost::~RenderHost()
     {
         af::Msg msg( af::Msg::TRenderDeregister, getId());
         bool ok;
-		af::Msg * answer = af::sendToServer( & msg, ok, af::VerboseOn);
+		af::Msg * answer = sendToServer( & msg, ok, af::VerboseOn);
 		if( answer ) delete answer;
         m_connected = false;
     }
 
+	if( m_server_connection )
+		delete m_server_connection;
+
     // Delete all tasks:
     for( std::vector<TaskProcess*>::iterator it = m_taskprocesses.begin(); it != m_taskprocesses.end(); )
     {
@@ -88,6 +96,34 @@ RenderHost::~RenderHost()
     }
 }
 
+af::Msg * RenderHost::waitServerEvents()
+{
+	af::Msg msg( af::Msg::TRenderEventsWait, getId());
+
+	bool ok;
+	af::Msg * answer = sendToServer( &msg, ok, af::VerboseOff);
+	if( NULL == answer )
+		return NULL;
+
+	// Server that does not know this message can answer something else,
+	// render should not skip sleeping in this case.
+	if(( answer->type() != af::Msg::TRenderEvents ) && ( answer->type() != af::Msg::TRenderId ))
+	{
+		delete answer;
+		return NULL;
+	}
+
+	return answer;
+}
+
+af::Msg * RenderHost::sendToServer( af::Msg * i_msg, bool & o_ok, af::VerboseMode i_verbose)
+{
+	if( m_server_connection )
+		return m_server_connection->send( i_msg, o_ok, i_verbose);
+
+	return af::sendToServer( i_msg, o_ok, i_verbose);
+}
+
 RenderHost * RenderHost::getInstance()
 {
 	// Does not return a reference, although sometimes recommanded for a
@@ -155,6 +191,9 @@ void RenderHost::refreshTasks()
     if( false == AFRunning )
         return;
 
+    // Output streaming budget is shared by all tasks:
+    m_output_budget = af::Environment::getRenderOutputStreamBudget();
+
     // Refresh tasks:
     for( int t = 0; t < m_taskprocesses.size(); t++)
     {
@@ -244,7 +283,7 @@ af::Msg * RenderHost::updateServer()
 	#endif
 
 	bool ok;
-	af::Msg * server_answer = af::sendToServer( msg, ok,
+	af::Msg * server_answer = sendToServer( msg, ok,
 		msg->type() == af::Msg::TRenderRegister ? af::VerboseOff : af::VerboseOn);
 
 	if( ok )
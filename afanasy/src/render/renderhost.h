@@ -5,6 +5,7 @@
 #include "../libafanasy/msgqueue.h"
 #include "../libafanasy/render.h"
 #include "../libafanasy/renderupdate.h"
+#include "../libafanasy/serverconnection.h"
 
 #include "taskprocess.h"
 
@@ -54,6 +55,13 @@ public:
 	*/
 	af::Msg * updateServer();
 
+	/**
+	* @brief Wait for server events till the next heartbeat.
+	* Server answers as soon as it has new events for this render.
+	* @return Server answer, or NULL if waiting failed and render should sleep.
+	*/
+	af::Msg * waitServerEvents();
+
 	/**
 	* @brief Get machine resources.
 	* Custom resources also called there.
@@ -96,6 +104,14 @@ public:
 	*/
 	inline void addTaskUp( af::MCTaskUp * i_tup) { m_up.addTaskUp( i_tup);}
 
+	/**
+	* @brief Take bytes from running tasks output streaming budget of the current heartbeat.
+	* @param i_size Bytes wanted
+	* @return Bytes allowed to send
+	*/
+	inline int takeOutputBudget( int i_size)
+		{ if( i_size > m_output_budget ) i_size = m_output_budget; m_output_budget -= i_size; return i_size; }
+
 	/**
 	* @brief Write task output on next update.
 	* This needed when you ask running task output from GUI.
@@ -123,6 +139,9 @@ private:
 	*/
 	void setUpdateMsgType( int i_type);
 
+	/// Send a message using persistent connection, if configured.
+	af::Msg * sendToServer( af::Msg * i_msg, bool & o_ok, af::VerboseMode i_verbose);
+
 private:
 	/// Windows to kill on windows
 	/// Bad mswin applications like to raise a gui window with an error and waits for some 'Ok' button.
@@ -136,6 +155,10 @@ private:
 	/// Count times render failed to send update message to server
 	int  m_connection_lost_count;
 
+	/// Persistent connection to server, if configured.
+	/// It is NULL if render connects to server for each message.
+	af::ServerConnection * m_server_connection;
+
 	/// Heartbeat message to sent at each update.
 	/// It is initially a `TRenderRegister` and as soon as the server
 	/// registered the render, it becomes a `TRenderUpdate`.
@@ -152,4 +175,7 @@ private:
 
 	/// Time when render has at least on task:
 	time_t m_has_tasks_time;
+
+	/// Running tasks output bytes that can be sent on the current heartbeat.
+	int m_output_budget;
 };
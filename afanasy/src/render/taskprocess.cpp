@@ -18,6 +18,7 @@ extern void (*fp_setupChildProcess)( void);
 
 #include "../include/afanasy.h"
 
+#include "../libafanasy/blockdata.h"
 #include "../libafanasy/environment.h"
 #include "../libafanasy/msgclasses/mctaskup.h"
 
@@ -90,7 +91,14 @@ TaskProcess::TaskProcess( af::TaskExec * i_taskExec, RenderHost * i_render):
 	af::pathMakePath( m_store_dir);
 
 	m_service = new af::Service( m_taskexec, m_store_dir);
-	m_parser = new ParserHost( m_service);
+	m_parser = new ParserHost( m_service, m_taskexec);
+
+	// Multi-host tasks output is not streamed, as several renders write the same task output.
+	// System job needs the whole output of an error task to store it in its log.
+	if(( af::Environment::getRenderOutputStreamBudget() > 0 ) && ( false == m_render->noOutputRedirection()) &&
+		(( m_taskexec->getBlockFlags() & af::BlockData::FMultiHost ) == 0 ) &&
+		( m_taskexec->getJobId() != AFJOB::SYSJOB_ID ))
+		m_parser->setStreaming();
 
 	m_cmd = m_service->getCommand();
 	AF_DEBUG << m_cmd.c_str();
@@ -455,13 +463,31 @@ void TaskProcess::sendTaskSate()
 	char * stdout_data = NULL;
 	int    stdout_size = 0;
 	std::string log;
+	std::string stream;
+	int64_t stream_offset = -1;
 
 	if(( m_update_status != af::TaskExec::UPPercent ) &&
 		( m_update_status != af::TaskExec::UPWarning ))
 	{
 		toRecieve = true;
-		stdout_data = m_parser->getData( &stdout_size);
 		log = m_service->getLog();
+
+		// Server already has streamed output, the rest is sent.
+		// It is not taken from parser, as finished task state is sent till server closes it.
+		if( m_parser->isStreaming())
+			m_parser->getStream( stream, stream_offset);
+		else
+			stdout_data = m_parser->getData( &stdout_size);
+	}
+	else if( m_parser->isStreaming() && m_render->isConnected())
+	{
+		m_parser->takeStream( m_render->takeOutputBudget( m_parser->getStreamSize()), stream, stream_offset);
+	}
+	else if( m_parser->isStreamStopped() && m_render->isConnected())
+	{
+		// Output overloaded, server should replace streamed output with the whole one:
+		stdout_data = m_parser->getData( &stdout_size);
+		m_parser->resetStreamStopped();
 	}
 
 	int percent          = m_parser->getPercent();
@@ -517,6 +543,15 @@ void TaskProcess::sendTaskSate()
 		stdout_size,
 		stdout_data);
 
+	// Stream portion is not stored in parser, so it should be copied:
+	if( stream.size())
+		taskup->copyData( stream.data(), stream.size());
+	if( stream_offset >= 0 )
+		taskup->setDataOffset( stream_offset);
+
+	if( taskup->getDataLen() && ( af::Environment::getRenderOutputCompressLevel() > 0 ))
+		taskup->compressData( af::Environment::getRenderOutputCompressLevel());
+
 	collectFiles( *taskup);
 	taskup->setParsedFiles( m_service->getParsedFiles());
 
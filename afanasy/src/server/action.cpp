@@ -4,18 +4,17 @@
 
 #include "afcommon.h"
 
-Action::Action( const af::Msg * i_msg, ThreadArgs * i_args):
+Action::Action( af::Msg * i_msg, ThreadArgs * i_args):
 	without_answer( false),
 	jobs( i_args->jobs),
 	monitors( i_args->monitors),
 	renders( i_args->renders),
 	users( i_args->users),
-	m_buffer( NULL),
 	m_valid( false)
 {
+	// Action is processed by run thread at last, message is not needed after.
 	std::string error;
-	m_buffer = af::jsonParseMsg( m_document, i_msg, &error);
-	if( m_buffer == NULL )
+	if( false == af::jsonParseMsgInsitu( m_document, i_msg, &error))
 	{
 		AFCommon::QueueLogError( error);
 		return;
@@ -65,5 +64,4 @@ Action::Action( const af::Msg * i_msg, ThreadArgs * i_args):
 
 Action::~Action()
 {
-	if( m_buffer ) delete [] m_buffer;
 }
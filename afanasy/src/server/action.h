@@ -7,7 +7,8 @@
 class Action
 {
 public:
-	Action( const af::Msg * i_msg, ThreadArgs * i_args);
+	/// Message is parsed in place, its data is changed.
+	Action( af::Msg * i_msg, ThreadArgs * i_args);
 	~Action();
 
 	inline bool isValid()   const { return m_valid;          }
@@ -34,5 +35,4 @@ public:
 private:
 	bool m_valid;
 	rapidjson::Document m_document;
-	char * m_buffer;
 };
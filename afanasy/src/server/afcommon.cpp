@@ -267,3 +267,40 @@ bool AFCommon::writeFile( const char * data, const int length, const std::string
 	return true;
 }
 
+bool AFCommon::appendFile( const char * data, const int length, const std::string & filename)
+{
+	if( filename.size() == 0)
+	{
+		QueueLogError("AFCommon::appendFile: File name is empty.");
+		return false;
+	}
+
+	#ifdef WINNT
+	int fd = _open( filename.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_BINARY, 0644);
+	#else
+	int fd = open( filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+	#endif
+	if( fd == -1 )
+	{
+		QueueLogErrno( std::string("AFCommon::appendFile: ") + filename);
+		return false;
+	}
+	int bytes = 0;
+	while( bytes < length )
+	{
+		int written = write( fd, data+bytes, length-bytes);
+		if( written == -1 )
+		{
+			QueueLogErrno( std::string("AFCommon::appendFile: ") + filename);
+			close( fd);
+			return false;
+		}
+		bytes += written;
+	}
+
+	close( fd);
+
+	AFINFA("AFCommon::appendFile - \"%s\"", filename.c_str())
+	return true;
+}
+
@@ -29,6 +29,7 @@ public:
 	static void saveLog( const std::list<std::string> & log, const std::string & dirname, const std::string & filename);
 
 	static bool writeFile( const char * data, const int length, const std::string & filename); ///< Write a file
+	static bool appendFile( const char * data, const int length, const std::string & filename); ///< Append data to a file end
 	inline static bool writeFile( const std::string & i_str, const std::string & i_file_name)
 		{ return writeFile( i_str.c_str(), i_str.size(), i_file_name);}
 	inline static bool writeFile( const std::ostringstream & i_str, const std::string & i_file_name)
@@ -77,6 +78,7 @@ public:
 		const af::Job * i_job,
 		const af::Render * i_render)
 		{ if( ms_DBQueue ) ms_DBQueue->addTask( i_exec, i_progress, i_job, i_render );}
+	inline static void DBJsonWrite( std::ostringstream & o_str) { if( ms_DBQueue ) ms_DBQueue->jsonWrite( o_str);}
 
 private:
 	static FileQueue * FileWriteQueue;
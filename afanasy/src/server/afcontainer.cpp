@@ -3,6 +3,7 @@
 #include <stdio.h>
 
 #include "../libafanasy/msgclasses/mcafnodes.h"
+#include "../libafanasy/msgstream.h"
 #include "../libafanasy/regexp.h"
 
 #include "action.h"
@@ -193,7 +194,7 @@ af::Msg * AfContainer::generateList( int i_type)
 af::Msg * AfContainer::generateList( int i_type, const std::string & i_type_name, const std::vector<int32_t> & i_ids, const std::string & i_mask, bool i_json)
 {
 	af::MCAfNodes mcnodes;
-	std::ostringstream str;
+	af::MsgStream str;
 
 	if( i_json )
 		str << "{\"" << i_type_name << "\":[\n";
@@ -205,17 +206,14 @@ af::Msg * AfContainer::generateList( int i_type, const std::string & i_type_name
 	else
 		generateListAll( i_type, mcnodes, str, i_json);
 
-	af::Msg * msg = new af::Msg();
-
 	if( i_json )
 	{
 		str << "\n]}";
-		std::string s = str.str();
-		msg->setData( s.size(), s.c_str(), af::Msg::TJSON);
+		return str.generateMsg();
 	}
-	else
-		msg->set( i_type, &mcnodes);
 
+	af::Msg * msg = new af::Msg();
+	msg->set( i_type, &mcnodes);
 	return msg;
 }
 
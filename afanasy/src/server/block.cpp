@@ -22,6 +22,9 @@ Block::Block( JobAf * blockJob, af::BlockData * blockData, af::JobProgress * pro
    m_tasks( NULL),
    m_user( NULL),
    m_jobprogress( progress),
+   m_refresh_errors_retries( -1),
+   m_refresh_errors_forgive_time( -1),
+   m_modified_gen( 0),
    m_initialized( false)
 {
    m_tasks = new Task*[ m_data->getTasksNum()];
@@ -31,6 +34,15 @@ Block::Block( JobAf * blockJob, af::BlockData * blockData, af::JobProgress * pro
       return;
    }
    for( int t = 0; t < m_data->getTasksNum(); t++) m_tasks[t] = NULL;
+
+   // All tasks are refreshed on the first cycle,
+   // as tasks loaded from store can wait for reconnect or have errors.
+   m_refresh_tasks_flags.assign( m_data->getTasksNum(), true);
+   m_refresh_tasks.reserve( m_data->getTasksNum());
+   m_tasks_modified_gen.assign( m_data->getTasksNum(), 0);
+   for( int t = 0; t < m_data->getTasksNum(); t++)
+      m_refresh_tasks.push_back( t);
+
    for( int t = 0; t < m_data->getTasksNum(); t++)
    {
 	  m_tasks[t] = new Task( this, progress->tp[ m_data->getBlockNum()][t], t);
@@ -240,11 +252,11 @@ bool Block::canRunOn( RenderAf * render)
    if( m_data->getNeedPower()  > render->getHost().m_power       ) return false;
 
    // check hosts mask:
-   if( false == m_data->checkHostsMask( render->getName())) return false;
+   if( false == m_data->checkHostsMask( render->getName(), render->getNameMatches())) return false;
    // check exclude hosts mask:
-   if( false == m_data->checkHostsMaskExclude( render->getName())) return false;
+   if( false == m_data->checkHostsMaskExclude( render->getName(), render->getNameMatches())) return false;
    // Check needed properties:
-   if( false == m_data->checkNeedProperties( render->getHost().m_properties)) return false;
+   if( false == m_data->checkNeedProperties( render->getHost().m_properties, render->getPropertiesMatches())) return false;
 
    return true;
 }
@@ -252,44 +264,18 @@ bool Block::canRunOn( RenderAf * render)
 void Block::addRenderCounts( RenderAf * render)
 {
    m_job->addRenderCounts( render);
-   std::list<RenderAf*>::iterator rit = m_renders_ptrs.begin();
-   std::list<int>::iterator cit = m_renders_counts.begin();
-   for( ; rit != m_renders_ptrs.end(); rit++, cit++)
-      if( render == *rit )
-      {
-         (*cit)++;
-         return;
-      }
-   m_renders_ptrs.push_back( render);
-   m_renders_counts.push_back( 1);
+   m_renders_counts.increment( render->getId());
 }
 
 int Block::getRenderCounts( RenderAf * render) const
 {
-   std::list<RenderAf*>::const_iterator rit = m_renders_ptrs.begin();
-   std::list<int>::const_iterator cit = m_renders_counts.begin();
-   for( ; rit != m_renders_ptrs.end(); rit++, cit++)
-      if( render == *rit ) return *cit;
-   return 0;
+   return m_renders_counts.get( render->getId());
 }
 
 void Block::remRenderCounts( RenderAf * render)
 {
    m_job->remRenderCounts( render);
-   std::list<RenderAf*>::iterator rit = m_renders_ptrs.begin();
-   std::list<int>::iterator cit = m_renders_counts.begin();
-   for( ; rit != m_renders_ptrs.end(); rit++, cit++)
-      if( render == *rit )
-      {
-         if( *cit > 1 )
-            (*cit)--;
-         else
-         {
-			m_renders_ptrs.erase( rit);
-			m_renders_counts.erase( cit);
-         }
-         return;
-      }
+   m_renders_counts.decrement( render->getId());
 }
 
 bool Block::v_refresh( time_t currentTime, RenderContainer * renders, MonitorContainer * monitoring)
@@ -300,12 +286,40 @@ bool Block::v_refresh( time_t currentTime, RenderContainer * renders, MonitorCon
       return false;
    }
 
-   // refresh tasks
-   for( int t = 0; t < m_data->getTasksNum(); t++)
+   // error tasks are refreshed only while they can be retried or forgiven,
+   // so block or user errors settings change should refresh them again
+   if(( m_refresh_errors_retries != getErrorsRetries()) || ( m_refresh_errors_forgive_time != getErrorsForgiveTime()))
    {
+      m_refresh_errors_retries = getErrorsRetries();
+      m_refresh_errors_forgive_time = getErrorsForgiveTime();
+      for( int t = 0; t < m_data->getTasksNum(); t++)
+         if( m_tasks[t]->isRefreshNeeded() && ( false == m_refresh_tasks_flags[t] ))
+         {
+            m_refresh_tasks_flags[t] = true;
+            m_refresh_tasks.push_back( t);
+         }
+   }
+
+   // refresh tasks that have timers, a task can be appended again while refreshing
+   std::vector<int> refresh_tasks;
+   refresh_tasks.swap( m_refresh_tasks);
+   for( std::vector<int>::const_iterator it = refresh_tasks.begin(); it != refresh_tasks.end(); it++)
+   {
+      int t = *it;
+      m_refresh_tasks_flags[t] = false;
+
       int errorHostId = -1;
 	  m_tasks[t]->v_refresh( currentTime, renders, monitoring, errorHostId);
       if( errorHostId != -1 ) v_errorHostsAppend( t, errorHostId, renders);
+
+      // Refreshed task progress (percent, times) can change any cycle
+      m_data->setTaskProgressChanged( t);
+
+      if( m_tasks[t]->isRefreshNeeded() && ( false == m_refresh_tasks_flags[t] ))
+      {
+         m_refresh_tasks_flags[t] = true;
+         m_refresh_tasks.push_back( t);
+      }
    }
 
    // For block progress monitoring in jobs list and in tasks list
@@ -366,12 +380,43 @@ bool Block::v_refresh( time_t currentTime, RenderContainer * renders, MonitorCon
    if( old_block_state != m_data->getState()) blockProgress_changed = true;
 
    // update block monitoring and database if needed
+   if( blockProgress_changed )
+		setModified();
    if( blockProgress_changed && monitoring )
 		monitoring->addBlock( af::Msg::TBlocksProgress, m_data);
 
    return blockProgress_changed;
 }
 
+void Block::taskChanged( int i_task)
+{
+	if(( i_task < 0 ) || ( i_task >= int( m_refresh_tasks_flags.size())))
+		return;
+
+	m_data->setTaskProgressChanged( i_task);
+
+	setTaskModified( i_task);
+
+	if( m_refresh_tasks_flags[i_task] )
+		return;
+
+	m_refresh_tasks_flags[i_task] = true;
+	m_refresh_tasks.push_back( i_task);
+}
+
+void Block::setModified()
+{
+	m_modified_gen = m_job->setModified();
+}
+
+void Block::setTaskModified( int i_task)
+{
+	setModified();
+
+	if(( i_task >= 0 ) && ( i_task < int( m_tasks_modified_gen.size())))
+		m_tasks_modified_gen[i_task] = m_modified_gen;
+}
+
 bool Block::checkDepends( MonitorContainer * i_monitoring)
 {
 	bool was_depend = m_data->getState() & AFJOB::STATE_WAITDEP_MASK;
@@ -391,6 +436,7 @@ bool Block::checkDepends( MonitorContainer * i_monitoring)
 	{
 		m_data->setStateDependent( now_depend);
 
+		setModified();
 		if( i_monitoring )
 			i_monitoring->addBlock( af::Msg::TBlocksProgress, m_data);
 
@@ -466,6 +512,7 @@ bool Block::action( Action & i_action)
 	if( blockchanged_type )
 	{
 //AFCommon::QueueDBUpdateItem( (afsql::DBBlockData*)m_data);
+		setModified();
 		i_action.monitors->addBlock( af::Msg::TBlocksProperties, m_data);
 	}
 
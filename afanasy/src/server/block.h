@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../libafanasy/blockdata.h"
+#include "../libafanasy/idcounters.h"
 #include "../libafanasy/name_af.h"
 
 #include "useraf.h"
@@ -64,6 +65,21 @@ public:
 
 	bool tasksDependsOn( int block);
 
+	/// Task calls it on any its progress change.
+	/** Block progress accounts changed tasks only,
+	*** and only tasks that have timers are refreshed each cycle. **/
+	void taskChanged( int i_task);
+
+	/// Mark block changed for jobs delta lists, job is marked too.
+	void setModified();
+
+	/// Mark task changed for jobs delta lists, block and job are marked too.
+	void setTaskModified( int i_task);
+
+	inline int64_t getModifiedGen() const { return m_modified_gen; }
+	inline int64_t getTaskModifiedGen( int i_task) const
+		{ return ( i_task < int( m_tasks_modified_gen.size())) ? m_tasks_modified_gen[i_task] : m_modified_gen; }
+
 public:
 	JobAf * m_job;
 	af::BlockData * m_data;
@@ -81,8 +97,17 @@ private:
 	std::list<int>          m_errorHostsCounts; ///< Number of errors on error host.
 	std::list<time_t>       m_errorHostsTime;   ///< Time of the last error
 
-	std::list<RenderAf*> m_renders_ptrs;
-	std::list<int> m_renders_counts;
+	af::IdCounters m_renders_counts; ///< Running tasks number per render id.
+
+	std::vector<int>  m_refresh_tasks;       ///< Tasks to refresh on the next cycle.
+	std::vector<bool> m_refresh_tasks_flags;
+
+	/// Errors settings tasks were refreshed with, error tasks are refreshed again on a change.
+	int m_refresh_errors_retries;
+	int m_refresh_errors_forgive_time;
+
+	int64_t m_modified_gen;                    ///< Generation of the last block or its tasks change.
+	std::vector<int64_t> m_tasks_modified_gen; ///< Generations of the last tasks changes.
 
 	std::list<int> m_dependBlocks;
 	std::list<int> m_dependTasksBlocks;
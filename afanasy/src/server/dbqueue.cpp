@@ -1,7 +1,12 @@
 #include "dbqueue.h"
 
+#ifndef WINNT
+#include <unistd.h>
+#endif
+
 #include "../include/afanasy.h"
 
+#include "../libafanasy/common/dlScopeLocker.h"
 #include "../libafanasy/environment.h"
 
 #include "../libafsql/dbconnection.h"
@@ -9,6 +14,7 @@
 
 #include "afcommon.h"
 #include "monitorcontainer.h"
+#include "runcycle.h"
 
 extern bool AFRunning;
 
@@ -16,15 +22,44 @@ extern bool AFRunning;
 #undef AFOUTPUT
 #include "../include/macrooutput.h"
 
+namespace
+{
+/// Maximum rows of a prepared insert statement, smaller statements have rows number of a power of two.
+const int StatementMaxRows = 64;
+}
+
 DBQueue::DBQueue( const std::string & i_name, MonitorContainer * i_monitorcontainer):
 	af::AfQueue( i_name, af::AfQueue::e_start_thread),
+	m_conn( NULL),
 	m_monitors( i_monitorcontainer),
 	m_working( false),
-	m_conn( NULL)
+	m_journal( NULL),
+	m_spilling( false),
+	m_replaying( false),
+	m_replay_queued( false),
+	m_replay_offset( 0),
+	m_spill_pending( 0),
+	m_spilled( 0),
+	m_spill_failed( 0),
+	m_replayed( 0),
+	m_batches( 0),
+	m_items_written( 0),
+	m_rows_written( 0),
+	m_items_failed( 0),
+	m_batch_last( 0),
+	m_batch_max( 0),
+	m_flush_last_msec( 0),
+	m_flush_max_msec( 0),
+	m_flush_sum_msec( 0)
 {
 	if( false == afsql::DBConnection::enabled() )
 		return;
 
+	m_journal_file = af::Environment::getStoreFolder() + AFGENERAL::PATH_SEPARATOR + AFDATABASE::JOURNAL_FILE;
+	m_replay_file = m_journal_file + ".replay";
+	m_offset_file = m_replay_file + ".offset";
+	m_journal = new DBJournal( i_name + " journal", m_journal_file, this);
+
 	m_conn = PQconnectdb( af::Environment::get_DB_ConnInfo().c_str());
 	if( PQstatus( m_conn) != CONNECTION_OK)
 	{
@@ -36,10 +71,30 @@ DBQueue::DBQueue( const std::string & i_name, MonitorContainer * i_monitorcontai
 		connectionEstablished();
 		m_working = true;
 	}
+
+	// Items spilled by the previous server run:
+	m_replaying = af::pathFileExists( m_replay_file);
+	m_spilling  = af::pathFileExists( m_journal_file);
+	if( m_replaying )
+	{
+		std::ifstream offset( m_offset_file.c_str());
+		offset >> m_replay_offset;
+		if( offset.fail())
+			m_replay_offset = 0;
+	}
+	if( m_working && ( m_replaying || m_spilling ))
+	{
+		AFCommon::QueueLog( name + ": Database journal found, it will be replayed.");
+		m_replay_queued = true;
+		push( new Queries());
+	}
 }
 
 DBQueue::~DBQueue()
 {
+	if( m_journal )
+		delete m_journal;
+
 	if( m_conn )
 	{
 		PQfinish( m_conn);
@@ -49,6 +104,9 @@ DBQueue::~DBQueue()
 void DBQueue::connectionEstablished()
 {
 	AFINFA("DBQueue::connectionEstablished: %s", name.c_str())
+
+	// Prepared statements live in a connection session:
+	m_prepared.clear();
 }
 
 void DBQueue::processItem( af::AfQueueItem* item)
@@ -90,35 +148,424 @@ void DBQueue::processItem( af::AfQueueItem* item)
 		}
 	}
 
-	// Writing an item and check if error:
-	if( false == writeItem( item))
+	// Take other queued items to write them in one transaction:
+	std::list<Queries*> batch;
+	batch.push_back((Queries*)item);
+	while( batch.size() < af::Environment::get_DB_BatchSize())
+	{
+		af::AfQueueItem * next = pop( af::AfQueue::e_no_wait);
+		if( next == NULL ) break;
+		batch.push_back((Queries*)next);
+	}
+
+	if( false == writeBatch( batch))
+	{
+		// Push items back to queue front to try them to write again next time:
+		std::list<Queries*>::reverse_iterator rit = batch.rbegin();
+		for( ; rit != batch.rend(); rit++)
+			push( *rit, true );
+		AFINFA("%s: Items pushed back to queue front.", name.c_str())
+		return;
+	}
+
+	// Spilled items are written when all items queued before are written:
+	if( getCount() == 0 )
+		replayJournal();
+}
+
+bool DBQueue::writeBatch( std::list<Queries*> & io_batch, const std::vector<int64_t> * i_offsets)
+{
+	// Empty items, that wake queue thread for journal replay, are not counted:
+	int items = 0;
+	int64_t rows = 0;
+	for( std::list<Queries*>::const_iterator it = io_batch.begin(); it != io_batch.end(); it++)
+	{
+		if( (*it)->getTable())
+			rows += (*it)->getValues()->size() / (*it)->getTable()->dbGetAttrsNum();
+		if( (*it)->getTable() || (*it)->size())
+			items++;
+	}
+
+	int64_t time_start = RunCycle::NowMSec();
+	int failed = 0;
+	bool connected = true;
+
+	// Writing items and check if error:
+	if( false == writeItems( io_batch))
 	{
-		// Check if database has just closed:
-		if( PQstatus( m_conn) != CONNECTION_OK)
+		// Write items one by one, to skip only failed ones:
+		std::list<Queries*>::iterator it = io_batch.begin();
+		for( int i = 0; it != io_batch.end(); i++)
 		{
-			if( m_conn != NULL )
+			std::list<Queries*> single( 1, *it);
+			if( false == writeItems( single))
 			{
-				PQfinish( m_conn);
-				m_conn = NULL;
+				// Check if database has just closed:
+				if( PQstatus( m_conn) != CONNECTION_OK)
+				{
+					if( m_conn != NULL )
+					{
+						PQfinish( m_conn);
+						m_conn = NULL;
+					}
+					connected = false;
+					break;
+				}
+				if( (*it)->getTable())
+					rows -= (*it)->getValues()->size() / (*it)->getTable()->dbGetAttrsNum();
+				failed++;
+			}
+
+			delete *it;
+			it = io_batch.erase( it);
+
+			// Replay should continue after this item, if connection will be lost on next ones:
+			if( i_offsets )
+			{
+				m_replay_offset = (*i_offsets)[i];
+				storeReplayOffset();
+
+				DlScopeLocker lock( &m_spill_mutex);
+				m_replayed++;
 			}
-			// Push item back to queue front to try it to write again next time:
-			push( item, true );
-			AFINFA("%s: Item pushed back to queue front.", name.c_str())
-			return;
 		}
 	}
-	delete item;
+
+	int64_t flush_msec = RunCycle::NowMSec() - time_start;
+
+	for( std::list<Queries*>::iterator it = io_batch.begin(); it != io_batch.end(); it++)
+	{
+		if( connected )
+		{
+			delete *it;
+			continue;
+		}
+
+		// Items not written stay in batch, only written ones are counted:
+		if( (*it)->getTable())
+			rows -= (*it)->getValues()->size() / (*it)->getTable()->dbGetAttrsNum();
+		if( (*it)->getTable() || (*it)->size())
+			items--;
+	}
+	if( connected )
+		io_batch.clear();
+
+	DlScopeLocker lock( &m_stats_mutex);
+	m_batches++;
+	m_items_written += items - failed;
+	m_rows_written += rows;
+	m_items_failed += failed;
+	m_batch_last = items;
+	if( m_batch_last > m_batch_max ) m_batch_max = m_batch_last;
+	m_flush_last_msec = flush_msec;
+	if( flush_msec > m_flush_max_msec ) m_flush_max_msec = flush_msec;
+	m_flush_sum_msec += flush_msec;
+
+	return connected;
+}
+
+void DBQueue::pushQueries( Queries * i_queries)
+{
+	DlScopeLocker lock( &m_spill_mutex);
+
+	int max = af::Environment::get_DB_QueueMax();
+	if(( false == m_spilling ) && ( false == m_replaying ) && (( max <= 0 ) || ( getCount() < max )))
+	{
+		push( i_queries);
+		return;
+	}
+
+	// Journal file is written by its own thread, not to wait for disk here:
+	m_spilling = true;
+	m_spill_pending++;
+	m_journal->pushQueries( i_queries);
 }
 
-bool DBQueue::writeItem( af::AfQueueItem* item)
+void DBQueue::journalWritten( Queries * i_queries, bool i_written)
 {
-//printf("DBQueue::writeItem:\n");
-	Queries * queries = (Queries*)item;
+	DlScopeLocker lock( &m_spill_mutex);
+
+	m_spill_pending--;
+
+	delete i_queries;
+
+	if( false == i_written )
+	{
+		// Item is dropped, as being pushed to memory queue it will be written before items spilled earlier:
+		m_spill_failed++;
+		return;
+	}
+
+	m_spilled++;
+
+	// Wake queue thread to replay journal, when memory queue will be written:
+	if( false == m_replay_queued )
+	{
+		m_replay_queued = true;
+		push( new Queries());
+	}
+}
+
+void DBQueue::replayJournal()
+{
+	for(;;)
+	{
+		{
+			DlScopeLocker lock( &m_spill_mutex);
+			m_replay_queued = false;
+
+			if( false == m_replaying )
+			{
+				if( false == m_spilling )
+					return;
+
+				// Take journal to replay, new items are spilled to a new journal.
+				// Items not written by journal thread yet will be in the new journal.
+				if( false == m_journal->takeJournal( m_replay_file))
+				{
+					// Journal thread has not written items yet, it will wake queue again:
+					if( false == af::pathFileExists( m_journal_file))
+						m_spilling = ( m_spill_pending > 0 );
+					return;
+				}
+				m_spilling = ( m_spill_pending > 0 );
+				m_replaying = true;
+				m_replay_offset = 0;
+				storeReplayOffset();
+			}
+		}
+
+		std::ifstream file( m_replay_file.c_str(), std::ios::in | std::ios::binary);
+		file.seekg( m_replay_offset);
+
+		for(;;)
+		{
+			std::list<Queries*> batch;
+			std::vector<int64_t> offsets;
+			while( batch.size() < af::Environment::get_DB_BatchSize())
+			{
+				Queries * queries = readRecord( file);
+				if( queries == NULL ) break;
+				batch.push_back( queries);
+				offsets.push_back( file.tellg());
+			}
+
+			if( batch.empty())
+				break;
 
-	int size = queries->size();
-	if( size < 1) return true;
+			int items = batch.size();
+			if( false == writeBatch( batch, &offsets))
+			{
+				// Connection is lost, replay will continue from the first not written item:
+				for( std::list<Queries*>::iterator it = batch.begin(); it != batch.end(); it++)
+					delete *it;
+
+				DlScopeLocker lock( &m_spill_mutex);
+				m_replay_queued = true;
+				push( new Queries());
+				return;
+			}
+
+			// Items written one by one have stored the offset already:
+			if( m_replay_offset != offsets.back())
+			{
+				m_replay_offset = offsets.back();
+				storeReplayOffset();
+
+				DlScopeLocker lock( &m_spill_mutex);
+				m_replayed += items;
+			}
+		}
 
-	return afsql::execute( m_conn, queries);
+		if( false == file.eof())
+			AFCommon::QueueLogError( name + ": Database journal is corrupted, the rest is skipped:\n" + m_replay_file);
+		file.close();
+
+		if( remove( m_replay_file.c_str()) != 0 )
+			AFCommon::QueueLogErrno( name + ": Unable to remove database journal:\n" + m_replay_file);
+		remove( m_offset_file.c_str());
+
+		DlScopeLocker lock( &m_spill_mutex);
+		m_replaying = false;
+	}
+}
+
+void DBQueue::storeReplayOffset()
+{
+	// Server can be stopped during replay, written items should not be written again:
+	std::ofstream file( m_offset_file.c_str(), std::ios::out | std::ios::trunc);
+	file << m_replay_offset << '\n';
+	file.close();
+	if( file.fail())
+		AFCommon::QueueLogErrno( name + ": Unable to store database journal replay offset:\n" + m_offset_file);
+}
+
+void DBQueue::writeRecord( std::ostream & o_stream, const Queries * i_queries) const
+{
+	// Record is a type and strings number line, and each string with its length line:
+	char type = 'q';
+	if( i_queries->getTable() == &m_dbjob  ) type = 'j';
+	if( i_queries->getTable() == &m_dbtask ) type = 't';
+
+	const std::vector<std::string> & values = *i_queries->getValues();
+	o_stream << type << ' ' << ( type == 'q' ? i_queries->size() : values.size()) << '\n';
+
+	if( type == 'q' )
+	{
+		for( std::list<std::string>::const_iterator it = i_queries->begin(); it != i_queries->end(); it++)
+			o_stream << (*it).size() << '\n' << *it << '\n';
+	}
+	else
+	{
+		for( int i = 0; i < values.size(); i++)
+			o_stream << values[i].size() << '\n' << values[i] << '\n';
+	}
+}
+
+Queries * DBQueue::readRecord( std::istream & i_stream)
+{
+	char type = 0;
+	int count = -1;
+	i_stream >> type >> count;
+	i_stream.get();
+	if( i_stream.fail() || ( count < 0 ))
+		return NULL;
+
+	Queries * queries = NULL;
+	switch( type)
+	{
+		case 'q': queries = new Queries(); break;
+		case 'j': queries = new Queries( &m_dbjob); break;
+		case 't': queries = new Queries( &m_dbtask); break;
+		default: return NULL;
+	}
+
+	for( int i = 0; i < count; i++)
+	{
+		int size = -1;
+		i_stream >> size;
+		i_stream.get();
+		if( i_stream.fail() || ( size < 0 ))
+		{
+			delete queries;
+			return NULL;
+		}
+
+		std::string str( size, '\0');
+		if( size )
+			i_stream.read( &str[0], size);
+		i_stream.get();
+		if( i_stream.fail())
+		{
+			delete queries;
+			return NULL;
+		}
+
+		if( type == 'q' )
+			queries->push_back( str);
+		else
+			queries->getValues()->push_back( str);
+	}
+
+	return queries;
+}
+
+bool DBQueue::writeItems( const std::list<Queries*> & i_items)
+{
+//printf("DBQueue::writeItems:\n");
+	if( false == exec("BEGIN;"))
+		return false;
+
+	// Rows of neighbour items of the same table are inserted together:
+	const afsql::DBItem * table = NULL;
+	std::vector<const char*> params;
+
+	bool o_result = true;
+	std::list<Queries*>::const_iterator it = i_items.begin();
+	for( ; o_result && ( it != i_items.end()); it++)
+	{
+		Queries * queries = *it;
+
+		if(( table != NULL ) && ( queries->getTable() != table ))
+		{
+			o_result = insertRows( table, params);
+			table = NULL;
+		}
+
+		if( queries->getTable())
+		{
+			table = queries->getTable();
+			const std::vector<std::string> & values = *queries->getValues();
+			for( int i = 0; i < values.size(); i++)
+				params.push_back( values[i].c_str());
+			continue;
+		}
+
+		std::list<std::string>::const_iterator qIt = queries->begin();
+		for( ; o_result && ( qIt != queries->end()); qIt++)
+			o_result = exec( *qIt);
+	}
+
+	if( o_result && ( table != NULL ))
+		o_result = insertRows( table, params);
+
+	if( o_result )
+		o_result = exec("COMMIT;");
+	else
+		exec("ROLLBACK;");
+
+	return o_result;
+}
+
+bool DBQueue::exec( const std::string & i_query)
+{
+	PGresult * res = PQexec( m_conn, i_query.c_str());
+	bool o_result = ( PQresultStatus( res) == PGRES_COMMAND_OK );
+	if( false == o_result )
+		AFERRAR("SQL command execution failed:\n%s\n%s", i_query.c_str(), PQerrorMessage( m_conn));
+	PQclear( res);
+	return o_result;
+}
+
+bool DBQueue::insertRows( const afsql::DBItem * i_table, std::vector<const char*> & io_params)
+{
+	int attrs = i_table->dbGetAttrsNum();
+	int rows = io_params.size() / attrs;
+	int offset = 0;
+
+	while( rows > 0 )
+	{
+		int count = StatementMaxRows;
+		while( count > rows ) count >>= 1;
+
+		std::string statement = "af_insert_" + i_table->v_dbGetTableName() + "_" + af::itos( count);
+		if( m_prepared.find( statement) == m_prepared.end())
+		{
+			std::string query = i_table->dbInsertStatement( count);
+			PGresult * res = PQprepare( m_conn, statement.c_str(), query.c_str(), count * attrs, NULL);
+			bool prepared = ( PQresultStatus( res) == PGRES_COMMAND_OK );
+			if( false == prepared )
+				AFERRAR("SQL statement preparation failed:\n%s\n%s", query.c_str(), PQerrorMessage( m_conn));
+			PQclear( res);
+			if( false == prepared )
+				return false;
+			m_prepared.insert( statement);
+		}
+
+		PGresult * res = PQexecPrepared( m_conn, statement.c_str(), count * attrs, &io_params[offset * attrs], NULL, NULL, 0);
+		bool inserted = ( PQresultStatus( res) == PGRES_COMMAND_OK );
+		if( false == inserted )
+			AFERRAR("SQL rows insertion failed: %s\n%s", statement.c_str(), PQerrorMessage( m_conn));
+		PQclear( res);
+		if( false == inserted )
+			return false;
+
+		rows -= count;
+		offset += count;
+	}
+
+	io_params.clear();
+	return true;
 }
 
 void DBQueue::addItem( const afsql::DBItem * item)
@@ -127,7 +574,7 @@ void DBQueue::addItem( const afsql::DBItem * item)
 
 	Queries * queries = new Queries();
 	item->v_dbInsert( queries);
-	push( queries);
+	pushQueries( queries);
 }
 
 void DBQueue::updateItem( const afsql::DBItem * item, int attr)
@@ -136,7 +583,7 @@ void DBQueue::updateItem( const afsql::DBItem * item, int attr)
 
 	Queries * queries = new Queries();
 	item->v_dbUpdate( queries, attr);
-	push( queries);
+	pushQueries( queries);
 }
 
 void DBQueue::delItem( const afsql::DBItem * item)
@@ -145,7 +592,7 @@ void DBQueue::delItem( const afsql::DBItem * item)
 
 	Queries * queries = new Queries();
 	item->v_dbDelete( queries);
-	push( queries);
+	pushQueries( queries);
 }
 
 void DBQueue::addJob( const af::Job * i_job)
@@ -153,9 +600,14 @@ void DBQueue::addJob( const af::Job * i_job)
 //printf("DBQueue::addJob: (working=%d)\n", m_working);
 	if( false == m_working ) return;
 
-	Queries * queries = new Queries();
-	m_dbjob.add( i_job, queries);
-	push( queries);
+	Queries * queries = new Queries( &m_dbjob);
+	m_dbjob.add( i_job, queries->getValues());
+	if( queries->getValues()->empty())
+	{
+		delete queries;
+		return;
+	}
+	pushQueries( queries);
 //queries->stdOut();
 }
 
@@ -168,9 +620,41 @@ void DBQueue::addTask(
 //printf("DBQueue::addTask: (working=%d)\n", m_working);
 	if( false == m_working ) return;
 
-	Queries * queries = new Queries();
-	m_dbtask.add( i_exec, i_progress, i_job, i_render, queries);
-	push( queries);
+	Queries * queries = new Queries( &m_dbtask);
+	m_dbtask.add( i_exec, i_progress, i_job, i_render, queries->getValues());
+	if( queries->getValues()->empty())
+	{
+		delete queries;
+		return;
+	}
+	pushQueries( queries);
+}
+
+void DBQueue::jsonWrite( std::ostringstream & o_str)
+{
+	int depth = getCount();
+
+	DlScopeLocker lock( &m_stats_mutex);
+
+	o_str << "\"db_queue\":{";
+	o_str << "\"working\":" << ( m_working ? "true" : "false");
+	o_str << ",\"depth\":" << depth;
+	o_str << ",\"batches\":" << m_batches;
+	o_str << ",\"items_written\":" << m_items_written;
+	o_str << ",\"rows_written\":" << m_rows_written;
+	o_str << ",\"items_failed\":" << m_items_failed;
+	o_str << ",\"batch_last\":" << m_batch_last;
+	o_str << ",\"batch_max\":" << m_batch_max;
+	o_str << ",\"flush_last_msec\":" << m_flush_last_msec;
+	o_str << ",\"flush_max_msec\":" << m_flush_max_msec;
+	o_str << ",\"flush_avg_msec\":" << ( m_batches ? double( m_flush_sum_msec) / m_batches : 0.0);
+
+	DlScopeLocker spill_lock( &m_spill_mutex);
+	o_str << ",\"spilling\":" << ( m_spilling || m_replaying ? "true" : "false");
+	o_str << ",\"spilled\":" << m_spilled;
+	o_str << ",\"spill_failed\":" << m_spill_failed;
+	o_str << ",\"replayed\":" << m_replayed;
+	o_str << "}";
 }
 
 void DBQueue::sendAlarm()
@@ -188,3 +672,72 @@ void DBQueue::sendConnected()
 	AfContainerLock mLock( m_monitors, AfContainerLock::WRITELOCK);
 	m_monitors->announce( str);
 }
+
+DBJournal::DBJournal( const std::string & i_name, const std::string & i_journal_file, DBQueue * i_queue):
+	af::AfQueue( i_name, af::AfQueue::e_start_thread),
+	m_queue( i_queue),
+	m_journal_file( i_journal_file)
+{
+}
+
+DBJournal::~DBJournal()
+{
+}
+
+void DBJournal::processItem( af::AfQueueItem * i_item)
+{
+	Queries * queries = (Queries*)i_item;
+	bool written = true;
+
+	{
+		DlScopeLocker lock( &m_journal_mutex);
+
+		if( false == m_journal.is_open())
+			m_journal.open( m_journal_file.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+
+		std::streamoff size = m_journal.tellp();
+		m_queue->writeRecord( m_journal, queries);
+		m_journal.flush();
+
+		if( m_journal.fail())
+		{
+			AFCommon::QueueLogErrno( name + ": Unable to write database journal, item is dropped:\n" + m_journal_file);
+			m_journal.close();
+			m_journal.clear();
+			truncateJournal( size);
+			written = false;
+		}
+	}
+
+	m_queue->journalWritten( queries, written);
+}
+
+void DBJournal::truncateJournal( std::streamoff i_size)
+{
+	if( i_size < 0 )
+		return;
+#ifndef WINNT
+	if( truncate( m_journal_file.c_str(), i_size) != 0 )
+		AFCommon::QueueLogErrno( name + ": Unable to truncate database journal:\n" + m_journal_file);
+#endif
+}
+
+bool DBJournal::takeJournal( const std::string & i_new_name)
+{
+	DlScopeLocker lock( &m_journal_mutex);
+
+	if( m_journal.is_open())
+		m_journal.close();
+	m_journal.clear();
+
+	if( false == af::pathFileExists( m_journal_file))
+		return false;
+
+	if( rename( m_journal_file.c_str(), i_new_name.c_str()) != 0 )
+	{
+		AFCommon::QueueLogErrno( name + ": Unable to rename database journal:\n" + m_journal_file);
+		return false;
+	}
+
+	return true;
+}
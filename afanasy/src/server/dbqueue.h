@@ -2,15 +2,26 @@
 
 #include "../libafanasy/afqueue.h"
 
+#include <fstream>
+#include <set>
+
 #include "../libafsql/dbjob.h"
 #include "../libafsql/dbtask.h"
 #include "../libafsql/name_afsql.h"
 
+class DBQueue;
 class MonitorContainer;
 
 class Queries: public std::list<std::string>, public af::AfQueueItem
 {
 public:
+	Queries( const afsql::DBItem * i_table = NULL): m_table( i_table) {}
+
+	/// Table to insert rows values to, by a prepared statement.
+	inline const afsql::DBItem * getTable() const { return m_table;}
+	inline std::vector<std::string> * getValues() { return &m_values;}
+	inline const std::vector<std::string> * getValues() const { return &m_values;}
+
 	inline void stdOut() const
 	{
 		if( size())
@@ -18,9 +29,47 @@ public:
 		else
 			printf("Queries::stdOut: Zero size.\n");
 	}
+
+private:
+	const afsql::DBItem * m_table;
+	std::vector<std::string> m_values;
+};
+
+/// Database journal writer.
+/** Spilled items are written to the journal file by its own thread,
+*** as they are spilled by the run thread, that has all containers locked. **/
+class DBJournal : public af::AfQueue
+{
+public:
+	DBJournal( const std::string & i_name, const std::string & i_journal_file, DBQueue * i_queue);
+	virtual ~DBJournal();
+
+	inline void pushQueries( Queries * i_queries) { push( i_queries);}
+
+	/// Close journal file and rename it, returns false if there is no journal file.
+	bool takeJournal( const std::string & i_new_name);
+
+protected:
+	/// Called from journal thread to write an item.
+	virtual void processItem( af::AfQueueItem * i_item);
+
+private:
+	DBQueue * m_queue;
+
+	std::string   m_journal_file;
+	std::ofstream m_journal;
+	DlMutex       m_journal_mutex;
+
+	/// Truncate journal to the size before a failed record write, not to break next records.
+	void truncateJournal( std::streamoff i_size);
 };
 
 /// Simple FIFO database action queue
+/** Queued items are written in batches, each batch in one transaction.
+*** Jobs and tasks statistics rows are inserted by prepared multi-row statements.
+*** Queue size in memory is limited, other items are spilled to an append-only journal file.
+*** Journal is replayed in order, when all items queued in memory before are written.
+*** Replay position is stored after each written batch, to continue replay after server restart. **/
 class DBQueue : public af::AfQueue
 {
 public:
@@ -40,6 +89,8 @@ public:
 		const af::Job * i_job,
 		const af::Render * i_render);
 
+	void jsonWrite( std::ostringstream & o_str);
+
 protected:
 
 	/// Called from run thead to process item just poped from queue
@@ -48,12 +99,35 @@ protected:
 	/// Called when database connection opened (or reopened)
 	virtual void connectionEstablished();
 
-	/// Queries execution function
-	virtual bool writeItem(   af::AfQueueItem* item);
+	/// Queries execution function, all items are written in one transaction
+	virtual bool writeItems( const std::list<Queries*> & i_items);
 
 	PGconn * m_conn;
 
 private:
+	/// Push items to memory queue, or spill them to journal.
+	void pushQueries( Queries * i_queries);
+
+	/// Write and delete batch items, returns false if connection is lost (not written items stay in batch).
+	/** If items journal end offsets are given, replay offset is stored after each item written one by one. **/
+	bool writeBatch( std::list<Queries*> & io_batch, const std::vector<int64_t> * i_offsets = NULL);
+
+	/// Called from journal thread, when a spilled item is written to the journal.
+	void journalWritten( Queries * i_queries, bool i_written);
+
+	/// Write spilled items (should be called when memory queue is empty).
+	void replayJournal();
+
+	void storeReplayOffset();
+
+	void    writeRecord( std::ostream & o_stream, const Queries * i_queries) const;
+	Queries * readRecord( std::istream & i_stream);
+
+	bool exec( const std::string & i_query);
+
+	/// Insert rows by prepared statements, parameters are all rows attributes values.
+	bool insertRows( const afsql::DBItem * i_table, std::vector<const char*> & io_params);
+
 	void sendAlarm();
 	void sendConnected();
 
@@ -63,5 +137,35 @@ private:
 
 	afsql::DBJob m_dbjob;
 	afsql::DBTask m_dbtask;
+
+	/// Statements prepared on the current connection.
+	std::set<std::string> m_prepared;
+
+	std::string   m_journal_file;
+	std::string   m_replay_file;
+	std::string   m_offset_file;
+	DBJournal   * m_journal;
+	DlMutex       m_spill_mutex;
+	bool          m_spilling;      ///< Journal has items, new items should be spilled too.
+	bool          m_replaying;     ///< Replay file has items not written yet.
+	bool          m_replay_queued; ///< Empty item is queued to wake queue thread for replay.
+	int64_t       m_replay_offset; ///< Replay file position of the first not written item.
+	int64_t       m_spill_pending; ///< Items passed to the journal thread, but not written yet.
+	int64_t       m_spilled;
+	int64_t       m_spill_failed;
+	int64_t       m_replayed;
+
+	DlMutex  m_stats_mutex;
+	int64_t  m_batches;
+	int64_t  m_items_written;
+	int64_t  m_rows_written;
+	int64_t  m_items_failed;
+	int      m_batch_last;
+	int      m_batch_max;
+	int64_t  m_flush_last_msec;
+	int64_t  m_flush_max_msec;
+	int64_t  m_flush_sum_msec;
+
+	friend class DBJournal;
 };
 
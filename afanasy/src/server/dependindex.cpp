@@ -0,0 +1,146 @@
+#include "dependindex.h"
+
+#include "jobaf.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+DependIndex::DependIndex():
+	m_scans( 0),
+	m_changes( 0)
+{
+}
+
+DependIndex::~DependIndex()
+{
+}
+
+bool DependIndex::isChanged( const JobAf * i_job, const Depend & i_depend)
+{
+	return ( i_job->getUser() != i_depend.user ) ||
+		( i_job->getDependMask() != i_depend.mask ) ||
+		( i_job->getDependMaskGlobal() != i_depend.mask_global );
+}
+
+void DependIndex::update( JobAf * i_job)
+{
+	Record record;
+	record.name = i_job->getName();
+	record.user = i_job->getUser();
+	record.not_done = ( false == i_job->isDone());
+
+	std::map<const JobAf*, Record>::iterator rIt = m_records.find( i_job);
+	if( rIt == m_records.end())
+	{
+		account( i_job, record, 1);
+		m_records[i_job] = record;
+		m_changes++;
+	}
+	else if(( rIt->second.not_done != record.not_done ) || ( rIt->second.user != record.user ) || ( rIt->second.name != record.name ))
+	{
+		account( i_job, rIt->second, -1);
+		account( i_job, record, 1);
+		rIt->second = record;
+		m_changes++;
+	}
+
+	if(( false == i_job->hasDependMask()) && ( false == i_job->hasDependMaskGlobal()))
+	{
+		m_depends.erase( i_job);
+		return;
+	}
+
+	std::map<JobAf*, Depend>::iterator dIt = m_depends.find( i_job);
+	if(( dIt == m_depends.end()) || isChanged( i_job, dIt->second))
+		scan( i_job);
+}
+
+void DependIndex::remove( JobAf * i_job)
+{
+	m_depends.erase( i_job);
+
+	std::map<const JobAf*, Record>::iterator rIt = m_records.find( i_job);
+	if( rIt == m_records.end())
+		return;
+
+	account( i_job, rIt->second, -1);
+	m_records.erase( rIt);
+	m_changes++;
+}
+
+void DependIndex::getDepends( JobAf * i_job, bool & o_local, bool & o_global)
+{
+	o_local = false;
+	o_global = false;
+
+	std::map<JobAf*, Depend>::iterator dIt = m_depends.find( i_job);
+	if(( dIt == m_depends.end()) || isChanged( i_job, dIt->second))
+	{
+		update( i_job);
+		dIt = m_depends.find( i_job);
+		if( dIt == m_depends.end())
+			return;
+	}
+
+	o_local  = dIt->second.count        > 0;
+	o_global = dIt->second.count_global > 0;
+}
+
+void DependIndex::account( const JobAf * i_job, const Record & i_record, int i_sign)
+{
+	if( false == i_record.not_done )
+		return;
+
+	for( std::map<JobAf*, Depend>::iterator it = m_depends.begin(); it != m_depends.end(); it++)
+	{
+		if( it->first == i_job )
+			continue;
+
+		// Depend masks changed since the last scan,
+		// counters will be recalculated on this job update.
+		if( isChanged( it->first, it->second))
+			continue;
+
+		if(( i_record.user == it->second.user ) && it->first->hasDependMask() && it->first->checkDependMask( i_record.name))
+			it->second.count += i_sign;
+
+		if( it->first->hasDependMaskGlobal() && it->first->checkDependMaskGlobal( i_record.name))
+			it->second.count_global += i_sign;
+	}
+}
+
+void DependIndex::scan( JobAf * i_job)
+{
+	Depend & depend = m_depends[i_job];
+	depend.mask = i_job->getDependMask();
+	depend.mask_global = i_job->getDependMaskGlobal();
+	depend.user = i_job->getUser();
+	depend.count = 0;
+	depend.count_global = 0;
+
+	for( std::map<const JobAf*, Record>::const_iterator it = m_records.begin(); it != m_records.end(); it++)
+	{
+		if(( it->first == i_job ) || ( false == it->second.not_done ))
+			continue;
+
+		if(( it->second.user == depend.user ) && i_job->hasDependMask() && i_job->checkDependMask( it->second.name))
+			depend.count++;
+
+		if( i_job->hasDependMaskGlobal() && i_job->checkDependMaskGlobal( it->second.name))
+			depend.count_global++;
+	}
+
+	m_scans++;
+}
+
+void DependIndex::jsonWrite( std::ostringstream & o_str) const
+{
+	o_str << "\"depend_index\":{";
+	o_str << "\"jobs\":" << m_records.size();
+	o_str << ",\"depends\":" << m_depends.size();
+	o_str << ",\"scans\":" << m_scans;
+	o_str << ",\"changes\":" << m_changes;
+	o_str << "}";
+}
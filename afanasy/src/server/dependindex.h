@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../libafanasy/name_af.h"
+
+class JobAf;
+class UserAf;
+
+/// Jobs depend masks index.
+/** Stores the number of not done jobs matching each depend mask (local and global).
+*** Depend masks are matched on a job add, done state or user change only,
+*** not for every jobs pair on every run cycle. **/
+class DependIndex
+{
+public:
+	DependIndex();
+	~DependIndex();
+
+	/// Synchronize job state and its depend masks with the index.
+	/** Should be called when a job may change, it is cheap if nothing is changed. **/
+	void update( JobAf * i_job);
+
+	/// Remove job from index, when it becomes a zombie.
+	void remove( JobAf * i_job);
+
+	/// Get whether job has not done jobs matching its local and global depend masks.
+	void getDepends( JobAf * i_job, bool & o_local, bool & o_global);
+
+	void jsonWrite( std::ostringstream & o_str) const;
+
+private:
+	/// Job parameters that other jobs depend on.
+	struct Record
+	{
+		std::string name;
+		const UserAf * user;
+		bool not_done;
+	};
+
+	/// Depend masks state of a job.
+	struct Depend
+	{
+		std::string mask;
+		std::string mask_global;
+		const UserAf * user;
+		int count;         ///< Not done jobs of the same user matching local depend mask.
+		int count_global;  ///< Not done jobs matching global depend mask.
+	};
+
+private:
+	static bool isChanged( const JobAf * i_job, const Depend & i_depend);
+
+	/// Add or remove a record to all depend counters.
+	void account( const JobAf * i_job, const Record & i_record, int i_sign);
+
+	/// Calculate job depend counters from all records.
+	void scan( JobAf * i_job);
+
+private:
+	std::map<const JobAf*, Record> m_records;
+	std::map<JobAf*, Depend> m_depends;
+
+	int64_t m_scans;    ///< Number of full depend counters calculations.
+	int64_t m_changes;  ///< Number of job records changes.
+};
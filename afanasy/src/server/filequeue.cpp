@@ -1,8 +1,16 @@
 #include "filequeue.h"
 
+#include <functional>
+#include <stdio.h>
+
 #include "afcommon.h"
 #include "afnodesrv.h"
 
+#include "../include/afanasy.h"
+
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/environment.h"
+
 #define AFOUTPUT
 #undef AFOUTPUT
 #include "../include/macrooutput.h"
@@ -10,7 +18,10 @@
 FileData::FileData( const std::ostringstream & i_str, const std::string & i_file_name, const std::string & i_folder_name):
 	m_file_name( i_file_name),
 	m_folder_name( i_folder_name),
-	m_data( NULL)
+	m_data( NULL),
+	m_append( false),
+	m_remove( false),
+	m_cancelled( false)
 {
 	m_str = i_str.str();
 	m_length = m_str.size();
@@ -20,7 +31,10 @@ FileData::FileData( const char * i_data, int i_length, const std::string & i_fil
 	m_file_name( i_file_name),
 	m_folder_name( i_folder_name),
 	m_length( i_length),
-	m_data( NULL)
+	m_data( NULL),
+	m_append( false),
+	m_remove( false),
+	m_cancelled( false)
 {
 	AFINFA("FileData::FileData: \"%s\" %d bytes R(%d).", m_file_name.c_str(), m_length)
 
@@ -59,47 +73,255 @@ FileData::FileData( const char * i_data, int i_length, const std::string & i_fil
 
 FileData::FileData( const AfNodeSrv * i_node):
 	m_length( 0),
-	m_data( NULL)
+	m_data( NULL),
+	m_append( false),
+	m_remove( false),
+	m_cancelled( false)
 {
 	m_folder_name = i_node->getStoreDir();
 }
 
+FileData::FileData( const std::string & i_folder_name):
+	m_folder_name( i_folder_name),
+	m_length( 0),
+	m_data( NULL),
+	m_append( false),
+	m_remove( false),
+	m_cancelled( false)
+{
+}
+
 FileData::~FileData()
 {
 	if( m_data != NULL ) delete [] m_data;
 }
-FileQueue::FileQueue( const std::string & QueueName):
-	af::AfQueue( QueueName, af::AfQueue::e_start_thread)
+void FileData::merge( FileData * i_later)
+{
+	if( i_later->getFolderName().size())
+		m_folder_name = i_later->getFolderName();
+	if( i_later->getFolderRoot().size())
+		m_folder_root = i_later->getFolderRoot();
+
+	if(( false == i_later->isAppend()) || m_remove )
+	{
+		// Later whole file write or removal makes this write not needed,
+		// a write after removal creates the file again:
+		std::swap( m_data, i_later->m_data);
+		m_str.swap( i_later->m_str);
+		m_length = i_later->m_length;
+		m_remove = i_later->m_remove;
+		m_append = false;
+		return;
+	}
+
+	// Appends are joined, this write keeps its mode:
+	if( m_data )
+	{
+		m_str.assign( m_data, m_length);
+		delete [] m_data;
+		m_data = NULL;
+	}
+	m_str.append( i_later->getData(), i_later->getLength());
+	m_length = m_str.size();
+}
+
+FileLane::FileLane( const std::string & i_name, FileQueue * i_queue):
+	af::AfQueue( i_name, af::AfQueue::e_start_thread),
+	m_queue( i_queue)
 {
 }
 
-FileQueue::~FileQueue()
+FileLane::~FileLane()
 {
 }
 
-void FileQueue::processItem( af::AfQueueItem* item)
+bool FileLane::pushFile( FileData * i_filedata)
 {
-	FileData * filedata = (FileData*)item;
-	AFINFA("FileQueue::processItem: \"%s\"", filedata->getFileName().c_str())
+	{
+		DlScopeLocker lock( &m_pending_mutex);
+
+		std::map<std::string, FileData*>::iterator it = m_pending.find( i_filedata->getFileName());
+		if( it != m_pending.end())
+		{
+			it->second->merge( i_filedata);
+			delete i_filedata;
+			return true;
+		}
+
+		m_pending[i_filedata->getFileName()] = i_filedata;
+	}
+
+	return push( i_filedata);
+}
+
+void FileLane::cancelFolder( const std::string & i_folder)
+{
+	std::string prefix = i_folder + AFGENERAL::PATH_SEPARATOR;
+
+	m_write_mutex.Lock();
+	DlScopeLocker lock( &m_pending_mutex);
+
+	std::map<std::string, FileData*>::iterator it = m_pending.begin();
+	while( it != m_pending.end())
+	{
+		if( it->first.compare( 0, prefix.size(), prefix) == 0 )
+		{
+			it->second->m_cancelled = true;
+			m_pending.erase( it++);
+		}
+		else
+			it++;
+	}
+}
+
+void FileLane::unlock()
+{
+	m_write_mutex.Unlock();
+}
+
+void FileLane::processItem( af::AfQueueItem * i_item)
+{
+	FileData * filedata = (FileData*)i_item;
+	AFINFA("FileLane::processItem: \"%s\"", filedata->getFileName().c_str())
 
 	if( filedata->forDelete())
 	{
-		af::removeDir( filedata->getFolderName());
+		m_queue->removeFolder( filedata->getFolderName());
+		delete filedata;
+		return;
+	}
+
+	// Store folder can't be moved to trash while the file is written:
+	DlScopeLocker write_lock( &m_write_mutex);
+
+	// Later writes of the file will be queued, as this one is not pending any more:
+	{
+		DlScopeLocker lock( &m_pending_mutex);
+		if( false == filedata->m_cancelled )
+			m_pending.erase( filedata->getFileName());
+	}
+
+	if( filedata->m_cancelled )
+	{
+		delete filedata;
+		return;
+	}
+
+	if( filedata->isRemove())
+	{
+		if( af::pathFileExists( filedata->getFileName()))
+			if( ::remove( filedata->getFileName().c_str()) != 0 )
+				AFCommon::QueueLogErrno("FileQueue: Unable to remove file:\n" + filedata->getFileName());
 		delete filedata;
 		return;
 	}
 
 	if( filedata->getFolderName().size())
 		if( false == af::pathIsFolder( filedata->getFolderName()))
-			if( false == af::pathMakeDir( filedata->getFolderName()))
+		{
+			if( filedata->getFolderRoot().size() && ( false == af::pathIsFolder( filedata->getFolderRoot())))
+			{
+				// Node store was deleted
+				delete filedata;
+				return;
+			}
+
+			if( false == af::pathMakePath( filedata->getFolderName()))
 			{
 				AFCommon::QueueLogError("FileQueue: Unable to create folder:\n" + filedata->getFolderName());
 				delete filedata;
 				return;
 			}
+		}
 
-	AFCommon::writeFile( filedata->getData(), filedata->getLength(), filedata->getFileName());
+	if( filedata->isAppend())
+		AFCommon::appendFile( filedata->getData(), filedata->getLength(), filedata->getFileName());
+	else
+		AFCommon::writeFile( filedata->getData(), filedata->getLength(), filedata->getFileName());
 
 	delete filedata;
 }
 
+FileQueue::FileQueue( const std::string & QueueName):
+	m_trash_count( 0)
+{
+	int lanes = af::Environment::getServerFileQueueThreads();
+	if( lanes < 1 ) lanes = 1;
+	for( int i = 0; i < lanes; i++)
+		m_write_lanes.push_back( new FileLane( QueueName + " " + af::itos( i), this));
+
+	m_delete_lane = new FileLane( QueueName + " delete", this);
+
+	// Remove folders left in trash by the previous server run,
+	// each one separately, as trash is used by this run too:
+	m_trash_folder = af::Environment::getStoreFolder() + AFGENERAL::PATH_SEPARATOR + AFSERVER::TRASH_FOLDER;
+	std::vector<std::string> trash = af::getFilesList( m_trash_folder);
+	for( size_t i = 0; i < trash.size(); i++)
+		m_delete_lane->pushItem( new FileData( m_trash_folder + AFGENERAL::PATH_SEPARATOR + trash[i]));
+}
+
+FileQueue::~FileQueue()
+{
+	for( size_t i = 0; i < m_write_lanes.size(); i++)
+		delete m_write_lanes[i];
+	delete m_delete_lane;
+}
+
+bool FileQueue::pushFile( FileData * i_filedata)
+{
+	size_t hash = std::hash<std::string>()( i_filedata->getFileName());
+	return m_write_lanes[hash % m_write_lanes.size()]->pushFile( i_filedata);
+}
+
+bool FileQueue::pushNode( const AfNodeSrv * i_node)
+{
+	// Lanes are locked not to write pending files into the folder while it is moved,
+	// pending writes into the folder are cancelled not to create it again.
+	FileData * filedata = new FileData( i_node);
+	for( size_t i = 0; i < m_write_lanes.size(); i++)
+		m_write_lanes[i]->cancelFolder( filedata->getFolderName());
+
+	std::string folder = moveToTrash( filedata->getFolderName());
+
+	for( size_t i = 0; i < m_write_lanes.size(); i++)
+		m_write_lanes[i]->unlock();
+
+	if( folder.empty())
+	{
+		delete filedata;
+		return true;
+	}
+
+	filedata->m_folder_name = folder;
+	m_delete_lane->pushItem( filedata);
+
+	return true;
+}
+
+std::string FileQueue::moveToTrash( const std::string & i_folder)
+{
+	if( false == af::pathIsFolder( i_folder))
+		return std::string();
+
+	// Move folder out of the store tree at first,
+	// so a new node with the same store folder does not wait for removal.
+	if( false == af::pathIsFolder( m_trash_folder))
+		af::pathMakeDir( m_trash_folder);
+
+	std::string trash = m_trash_folder + AFGENERAL::PATH_SEPARATOR + af::itos( time( NULL)) + '.'
+		+ af::itos( m_trash_count++) + '.' + i_folder.substr( i_folder.find_last_of("/\\") + 1);
+
+	if( rename( i_folder.c_str(), trash.c_str()) == 0 )
+		return trash;
+
+	AFCommon::QueueLogErrno("FileQueue: Unable to move folder to trash:\n" + i_folder);
+	return i_folder;
+}
+
+void FileQueue::removeFolder( const std::string & i_folder)
+{
+	if( false == af::pathIsFolder( i_folder))
+		return;
+
+	af::removeDir( i_folder);
+}
@@ -2,6 +2,9 @@
 
 #include "../libafanasy/afqueue.h"
 
+#include <map>
+#include <vector>
+
 class AfNodeSrv;
 
 class FileData: public af::AfQueueItem
@@ -13,6 +16,7 @@ public:
 
 	// For clean up: (to delete store folder recursively)
 	FileData( const AfNodeSrv * i_node);
+	explicit FileData( const std::string & i_folder_name);
 
 	~FileData();
 
@@ -20,30 +24,102 @@ public:
 	inline const std::string & getFileName() const { return m_file_name; }
 	inline const std::string & getFolderName() const { return m_folder_name; }
 
+	/// Folder is created only inside an existing root, not to create a deleted node store again.
+	inline void setFolderRoot( const std::string & i_root) { m_folder_root = i_root; }
+	inline const std::string & getFolderRoot() const { return m_folder_root; }
+
 	inline int getLength() const { return m_length; }
 
 	inline bool forDelete() const { return ( m_folder_name.size() && m_file_name.empty() );}
 
+	/// Append data to the file end, instead of the whole file rewrite.
+	inline void setAppend() { m_append = true; }
+	inline bool isAppend() const { return m_append; }
+
+	/// Remove the file, in order with its writes.
+	inline void setRemove() { m_remove = true; }
+	inline bool isRemove() const { return m_remove; }
+
+	/// Merge a later write of the same file into this pending one.
+	/** Whole file write or removal replaces data, append adds data to the end. **/
+	void merge( FileData * i_later);
+
 private:
 	std::string m_file_name;
 	std::string m_folder_name;
+	std::string m_folder_root;
 	int m_length;
 	char * m_data;
 	std::string m_str;
+	bool m_append;
+	bool m_remove;
+	bool m_cancelled;       ///< Store folder was deleted, write is not needed.
+
+	friend class FileLane;
+	friend class FileQueue;
 };
 
-/// Simple FIFO filedata queue
-class FileQueue : public af::AfQueue
+class FileQueue;
+
+/// Simple FIFO filedata queue, with a thread to process it.
+class FileLane : public af::AfQueue
 {
 public:
-	FileQueue( const std::string & QueueName);
-	virtual ~FileQueue();
+	FileLane( const std::string & i_name, FileQueue * i_queue);
+	virtual ~FileLane();
 
-/// Push filedata to queue back.
-	inline bool pushFile( FileData* filedata) { return push( filedata);}
-	inline bool pushNode( const AfNodeSrv * i_node) { return push( new FileData( i_node));}
+/// Push filedata to queue back, or merge it to a pending write of the same file.
+	bool pushFile( FileData * i_filedata);
+
+	inline bool pushItem( FileData * i_filedata) { return push( i_filedata);}
+
+/// Cancel pending writes of files in a folder that is going to be deleted.
+/** Lane is locked until unlock() call, so no write can be in process while the folder is moved. **/
+	void cancelFolder( const std::string & i_folder);
+	void unlock();
 
 protected:
-	void processItem( af::AfQueueItem* item);
+	void processItem( af::AfQueueItem * i_item);
+
+private:
+	FileQueue * m_queue;
+
+	/// Pending (queued but not processed yet) write for each file path.
+	std::map<std::string, FileData*> m_pending;
+	DlMutex m_pending_mutex;
+
+	/// Locked while a file is written, locked before the pending mutex.
+	DlMutex m_write_mutex;
 };
 
+/// Files writing queue.
+/** Files are written by several lanes, a file path always goes to the same lane to keep writes order.
+*** Store folder of a deleted node is moved to the trash folder at once, when no lane writes,
+*** so a new node with the same store folder writes into a new one.
+*** Trash folders are removed by a separate lane. **/
+class FileQueue
+{
+public:
+	FileQueue( const std::string & QueueName);
+	~FileQueue();
+
+/// Push filedata to queue back.
+	bool pushFile( FileData * i_filedata);
+	bool pushNode( const AfNodeSrv * i_node);
+
+private:
+	/// Move a folder to trash, returns the trash folder, or the same folder on failure.
+	std::string moveToTrash( const std::string & i_folder);
+
+	/// Called by the deletion lane to remove a folder.
+	void removeFolder( const std::string & i_folder);
+
+private:
+	std::vector<FileLane*> m_write_lanes;
+	FileLane * m_delete_lane;
+
+	std::string m_trash_folder;
+	int m_trash_count;
+
+	friend class FileLane;
+};
@@ -69,7 +69,11 @@ af::Msg * httpGet( const af::Msg * i_msg)
 	if( file_name.size())
 	{
 		std::string error;
-		file_data = af::fileRead( file_name, &file_size, -1, &error);
+		// Tasks output can be stored compressed:
+		if(( false == af::pathFileExists( file_name)) && af::pathFileExists( file_name + ".gz"))
+			file_data = af::fileReadDecompress( file_name + ".gz", &file_size, -1, &error);
+		else
+			file_data = af::fileRead( file_name, &file_size, -1, &error);
 	}
 
 	if( file_data )
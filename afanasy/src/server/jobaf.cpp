@@ -6,6 +6,7 @@
 #include "../libafanasy/environment.h"
 #include "../libafanasy/jobprogress.h"
 #include "../libafanasy/msgqueue.h"
+#include "../libafanasy/msgstream.h"
 
 #include "action.h"
 #include "afcommon.h"
@@ -57,13 +58,7 @@ JobAf::JobAf( const std::string & i_store_dir, bool i_system):
 
 	readStore();
 
-	// Zero serial means that the job was created serials appeared in the project:
-	// ( system job has zero serial )
-	if( m_serial == 0 && ( false == i_system ))
-	{
-		m_serial = AFCommon::getJobSerial();
-		store();
-	}
+	// Zero serial is set on initialization, as stored jobs are constructed in parallel.
 }
 
 void JobAf::readStore()
@@ -84,11 +79,30 @@ void JobAf::readStore()
 
 	jsonRead( document);
 
+	// Thumbnail path is stored not to scan all tasks files folders:
+	std::string thumb_path;
+	af::jr_string("thumb_path", thumb_path, document);
+
 	delete [] res;
 	delete [] data;
 
+	if( thumb_path.size() && af::pathFileExists( thumb_path))
+	{
+		data = af::fileRead( thumb_path, &size);
+		if( data )
+		{
+			setThumbnail( thumb_path, size, data);
+			m_thumb_changed = false;
+			delete [] data;
+		}
+	}
+
 	m_progress = new af::JobProgress( this);
 
+	// Tasks progress log is read before tasks construction,
+	// tasks that are not in log will read their progress files.
+	m_tasks_progress_log_read = m_tasks_progress_log.read( m_progress);
+
 	construct();
 
 	for( int b = 0; b < m_blocks_num; b++)
@@ -105,6 +119,13 @@ void JobAf::initializeValues()
 	
 	m_thumb_changed    = false;
 	m_report_changed   = false;
+
+	m_solve_epoch      = 0;
+
+	m_modified_gen     = 0;
+	m_added_gen        = 0;
+
+	m_tasks_progress_log_read = false;
 	
 	m_logsWeight       = 0;
 	m_blackListsWeight = 0;
@@ -113,6 +134,7 @@ void JobAf::initializeValues()
 void JobAf::initStoreDirs()
 {
 	m_store_dir_tasks = getStoreDir() + AFGENERAL::PATH_SEPARATOR + "tasks";
+	m_tasks_progress_log.init( getStoreDir());
 }
 
 void JobAf::construct()
@@ -259,6 +281,14 @@ bool JobAf::initialize()
 	else
 	{
 		appendLog("Initialized from database.");
+
+		// Zero serial means that the job was created serials appeared in the project:
+		// ( system job has zero serial )
+		if(( m_serial == 0 ) && ( m_id != AFJOB::SYSJOB_ID ))
+		{
+			m_serial = AFCommon::getJobSerial();
+			store();
+		}
 	}
 
 	//
@@ -286,6 +316,21 @@ bool JobAf::initialize()
 			m_progress->tp[b][t]->state = taskstate;
 		}
 	}
+
+	// Convert stored tasks progress to the current store way:
+	if( isFromStore())
+	{
+		if( af::Environment::getServerStoreTasksProgressLog())
+			m_tasks_progress_log.compactRead( m_progress);
+		else if( m_tasks_progress_log_read )
+		{
+			for( int b = 0; b < m_blocks_num; b++)
+				for( int t = 0; t < m_blocks_data[b]->getTasksNum(); t++)
+					m_blocks[b]->m_tasks[t]->v_store();
+			m_tasks_progress_log.remove();
+		}
+		m_tasks_progress_log.clearLoaded();
+	}
 	
 	if(( m_state & AFJOB::STATE_DONE_MASK) == false ) m_state = m_state | AFJOB::STATE_WAITDEP_MASK;
 	
@@ -320,6 +365,7 @@ void JobAf::deleteNode( RenderContainer * renders, MonitorContainer * monitoring
 		if( getRunningTasksNumber() && (renders != NULL) && (monitoring != NULL))
 		{
 			restartAllTasks("Job deletion.", renders, monitoring, AFJOB::STATE_RUNNING_MASK);
+			setModified();
 			if( monitoring ) monitoring->addJobEvent( af::Monitor::EVT_jobs_change, getId(), getUid());
 			return;
 		}
@@ -345,6 +391,8 @@ void JobAf::deleteNode( RenderContainer * renders, MonitorContainer * monitoring
 	}
 	
 	setZombie();
+	ms_jobs->getDependIndex().remove( this);
+	ms_jobs->jobDeleted( m_id);
 	
 	AFCommon::DBAddJob( this);
 	
@@ -410,7 +458,10 @@ void JobAf::v_action( Action & i_action)
 		}
 
 		if( job_progress_changed )
+		{
+			setModified();
 			i_action.monitors->addJobEvent( af::Monitor::EVT_jobs_change, getId(), getUid());
+		}
 
 		if( i_action.log.size() )
 			store();
@@ -493,6 +544,7 @@ void JobAf::v_action( Action & i_action)
 			return;
 		}
 		appendLog("Operation \"" + type + "\" by " + i_action.author);
+		setModified();
 		i_action.monitors->addJobEvent( af::Monitor::EVT_jobs_change, getId(), getUid());
 		store();
 		return;
@@ -519,6 +571,7 @@ void JobAf::v_action( Action & i_action)
 		
 		m_user->removeJob( this);
 		user->addJob( this);
+		setModified();
 		
 		i_action.monitors->addEvent(    af::Monitor::EVT_users_change, m_user->getId());
 		i_action.monitors->addJobEvent( af::Monitor::EVT_jobs_add, getId(), m_user->getId());
@@ -531,6 +584,7 @@ void JobAf::v_action( Action & i_action)
 	if( i_action.log.size() )
 	{
 		store();
+		setModified();
 		i_action.monitors->addJobEvent( af::Monitor::EVT_jobs_change, getId(), getUid());
 	}
 }
@@ -557,78 +611,27 @@ void JobAf::checkDepends()
 	bool depend_local = false;
 	bool depend_global = false;
 	
-	// check global depends:
-	if( hasDependMaskGlobal())
-	{
-		JobContainerIt jobsIt( ms_jobs);
-		for( Job *job = jobsIt.job(); job != NULL; jobsIt.next(), job = jobsIt.job())
-		{
-			if( job == this ) continue;
-			if(( job->isDone() == false ) && ( checkDependMaskGlobal( job->getName()) ))
-			{
-				depend_global = true;
-				break;
-			}
-		}
-	}
-	
-	// check local depends:
-	if( hasDependMask())
-	{
-		AfListIt jobsListIt( m_user->getJobsList());
-		for( AfNodeSrv *job = jobsListIt.node(); job != NULL; jobsListIt.next(), job = jobsListIt.node())
-		{
-			if( job == this ) continue;
-			if(( ((JobAf*)job)->isDone() == false ) && ( checkDependMask( ((JobAf*)job)->getName()) ))
-			{
-				depend_local = true;
-				break;
-			}
-		}
-	}
+	// Depend masks matches are stored in the index,
+	// it changes only when some job is added, done or removed:
+	if( hasDependMask() || hasDependMaskGlobal())
+		ms_jobs->getDependIndex().getDepends( this, depend_local, depend_global);
 	
 	if( depend_local || depend_global ) m_state = m_state | AFJOB::STATE_WAITDEP_MASK;
 }
 
 void JobAf::addRenderCounts( RenderAf * render)
 {
-	std::list<RenderAf*>::iterator rit = renders_ptrs.begin();
-	std::list<int>::iterator cit = renders_counts.begin();
-	for( ; rit != renders_ptrs.end(); rit++, cit++)
-		if( render == *rit )
-		{
-			(*cit)++;
-			return;
-		}
-	renders_ptrs.push_back( render);
-	renders_counts.push_back( 1);
+	m_renders_counts.increment( render->getId());
 }
 
 int JobAf::getRenderCounts( RenderAf * render) const
 {
-	std::list<RenderAf*>::const_iterator rit = renders_ptrs.begin();
-	std::list<int>::const_iterator cit = renders_counts.begin();
-	for( ; rit != renders_ptrs.end(); rit++, cit++)
-		if( render == *rit ) return *cit;
-	return 0;
+	return m_renders_counts.get( render->getId());
 }
 
 void JobAf::remRenderCounts( RenderAf * render)
 {
-	std::list<RenderAf*>::iterator rit = renders_ptrs.begin();
-	std::list<int>::iterator cit = renders_counts.begin();
-	for( ; rit != renders_ptrs.end(); rit++, cit++)
-		if( render == *rit )
-		{
-			if( *cit > 1 )
-				(*cit)--;
-			else
-			{
-				renders_ptrs.erase( rit);
-				renders_counts.erase( cit);
-			}
-			return;
-		}
+	m_renders_counts.decrement( render->getId());
 }
 
 af::TaskExec * JobAf::genTask( RenderAf *render, int block, int task, std::list<int> * blocksIds, MonitorContainer * monitoring)
@@ -637,9 +640,9 @@ af::TaskExec * JobAf::genTask( RenderAf *render, int block, int task, std::list<
 	if( m_state & AFJOB::STATE_OFFLINE_MASK )
 		return NULL;
 
-	if( m_blocks[block]->m_tasks[task]->m_solved )
+	if( m_blocks[block]->m_tasks[task]->m_solved_epoch == m_solve_epoch )
 		return NULL;
-	m_blocks[block]->m_tasks[task]->m_solved = true;
+	m_blocks[block]->m_tasks[task]->m_solved_epoch = m_solve_epoch;
 
 	//
 	// Recursive dependence check, only if needed
@@ -653,6 +656,7 @@ af::TaskExec * JobAf::genTask( RenderAf *render, int block, int task, std::list<
 			{
 				appendLog( std::string("Block[") + m_blocks_data[block]->getName() + "] appears second time while job generating a task.\nJob has a recursive blocks tasks dependence.");
 				m_state = m_state | AFJOB::STATE_OFFLINE_MASK;
+				setModified();
 				if( monitoring ) monitoring->addJobEvent( af::Monitor::EVT_jobs_change, getId(), getUid());
 				return NULL;
 			}
@@ -843,25 +847,25 @@ bool JobAf::v_canRunOn( RenderAf * i_render)
 		return false;
 	
 	// check hosts mask:
-	if( false == checkHostsMask( i_render->getName()))
+	if( false == checkHostsMask( i_render->getName(), i_render->getNameMatches()))
 	{
 		return false;
 	}
 	
 	// check exclude hosts mask:
-	if( false == checkHostsMaskExclude( i_render->getName()))
+	if( false == checkHostsMaskExclude( i_render->getName(), i_render->getNameMatches()))
 	{
 		return false;
 	}
 	
 	// check needed os:
-	if( false == checkNeedOS( i_render->getHost().m_os))
+	if( false == checkNeedOS( i_render->getHost().m_os, i_render->getOSMatches()))
 	{
 		return false;
 	}
 	
 	// check needed properties:
-	if( false == checkNeedProperties( i_render->getHost().m_properties))
+	if( false == checkNeedProperties( i_render->getHost().m_properties, i_render->getPropertiesMatches()))
 	{
 		return false;
 	}
@@ -882,19 +886,21 @@ RenderAf * JobAf::v_solve( std::list<RenderAf*> & i_renders_list, MonitorContain
 
 bool JobAf::solveOnRender( RenderAf * i_render, MonitorContainer * i_monitoring)
 {
-	// Prepare for the new solving (reset previous solvind stored data):
-	for( int b = 0; b < m_blocks_num; b++)
+	// Prepare for the new solving.
+	// Previous solving marks are discarded by a new epoch, not by resetting all tasks.
+	// Tasks epoch is needed for recursion function, to not to try to solve the same task again:
+	m_solve_epoch++;
+	if( m_solve_epoch == 0 )
 	{
-		int numtasks = m_blocks_data[b]->getTasksNum();
-		for( int t = 0; t < numtasks; t++)
-		{
-			// Needed for recursion function, to not to try to solve the same task again
-			m_blocks[b]->m_tasks[t]->m_solved = false;
-			
-			// Needed to store tasks that was tried, for nonsequential case:
-			m_progress->tp[b][t]->setNotSolved();
-		}
+		// On overflow old marks can be equal to a new epoch:
+		for( int b = 0; b < m_blocks_num; b++)
+			for( int t = 0; t < m_blocks_data[b]->getTasksNum(); t++)
+				m_blocks[b]->m_tasks[t]->m_solved_epoch = 0;
+		m_solve_epoch = 1;
 	}
+	// Blocks store tasks that was tried, for nonsequential case:
+	for( int b = 0; b < m_blocks_num; b++)
+		m_blocks_data[b]->startSolving();
 	
 	for( int b = 0; b < m_blocks_num; b++)
 	{
@@ -1016,6 +1022,9 @@ void JobAf::v_refresh( time_t currentTime, AfContainer * pointer, MonitorContain
 	}
 	if( isLocked() ) return;
 	
+	// Apply job done state and depend masks changes, made since the previous cycle:
+	ms_jobs->getDependIndex().update( this);
+	
 	// for database and monitoring
 	uint32_t old_state = m_state;
 	uint32_t jobchanged = 0;
@@ -1134,6 +1143,10 @@ void JobAf::v_refresh( time_t currentTime, AfContainer * pointer, MonitorContain
 	
 	if( m_thumb_changed || m_report_changed )
 	{
+		// Store thumbnail path
+		if( m_thumb_changed )
+			store();
+
 		jobchanged = af::Monitor::EVT_jobs_change;
 		m_thumb_changed = false;
 		m_report_changed = false;
@@ -1153,6 +1166,7 @@ void JobAf::v_refresh( time_t currentTime, AfContainer * pointer, MonitorContain
 		}
 	}
 	
+	if( jobchanged ) setModified();
 	if(( monitoring ) &&  ( jobchanged )) monitoring->addJobEvent( jobchanged, getId(), getUid());
 	
 	// Update solving parameters:
@@ -1217,20 +1231,74 @@ void JobAf::writeProgress( af::Msg &msg)
 
 af::Msg * JobAf::writeProgress( bool json)
 {
-	af::Msg * msg = new af::Msg(); 
 	if( json )
 	{
-		std::ostringstream stream;
+		af::MsgStream stream;
 		m_progress->jsonWrite( stream);
-		std::string string = stream.str();
-		msg->setData( string.size(), string.c_str(), af::Msg::TJSON);
+		return stream.generateMsg();
 	}
-	else
+
+	return new af::Msg( af::Msg::TJobProgress, m_progress);
+}
+
+af::Msg * JobAf::writeProgressDelta( int64_t i_since) const
+{
+	// New job tasks are all unknown for client.
+	bool full = ( i_since < m_added_gen ) || ms_jobs->isDeltaFull( i_since);
+
+	af::MsgStream str;
+	str << "{\"job_progress\":{";
+	str << "\"id\":" << m_id;
+	str << ",\n\"generation\":" << ms_jobs->getModifiedGen();
+	if( full )
+		str << ",\n\"full\":true";
+	str << ",\n\"blocks\":[";
+
+	bool block_added = false;
+	for( int b = 0; b < m_blocks_num; b++)
 	{
-		msg->set( af::Msg::TJobProgress, m_progress);
+		if(( false == full ) && ( m_blocks[b]->getModifiedGen() <= i_since ))
+			continue;
+
+		if( block_added ) str << ",";
+		block_added = true;
+
+		str << "\n{\"block_num\":" << b << ",\"ranges\":[";
+
+		// Changed tasks are written by ranges of sequential tasks.
+		bool range_opened = false;
+		bool range_added = false;
+		for( int t = 0; t < m_blocks_data[b]->getTasksNum(); t++)
+		{
+			bool changed = full || ( m_blocks[b]->getTaskModifiedGen( t) > i_since );
+			if( changed )
+			{
+				if( range_opened )
+					str << ",\n";
+				else
+				{
+					if( range_added ) str << ",";
+					str << "\n{\"start\":" << t << ",\"progress\":[\n";
+					range_opened = true;
+					range_added = true;
+				}
+				m_progress->tp[b][t]->jsonWrite( str);
+			}
+			else if( range_opened )
+			{
+				str << "]}";
+				range_opened = false;
+			}
+		}
+		if( range_opened )
+			str << "]}";
+
+		str << "]}";
 	}
 
-	return msg;
+	str << "\n]}}";
+
+	return str.generateMsg();
 }
 
 af::Msg * JobAf::writeBlocks( std::vector<int32_t> i_block_ids, std::vector<std::string> i_modes, bool i_binary) const
@@ -1249,7 +1317,7 @@ af::Msg * JobAf::writeBlocks( std::vector<int32_t> i_block_ids, std::vector<std:
 		return new af::Msg( af::BlockData::DataModeFromString( i_modes[0]), &mcblocks);
 	}
 
-	std::ostringstream str;
+	af::MsgStream str;
 	str << "{\"blocks\":[\n";
 	for( int b = 0; b < i_block_ids.size(); b++)
 	{
@@ -1263,7 +1331,7 @@ af::Msg * JobAf::writeBlocks( std::vector<int32_t> i_block_ids, std::vector<std:
 	}
 	str << "\n]}";
 
-	return af::jsonMsg( str);
+	return str.generateMsg();
 }
 
 af::Msg * JobAf::writeTask( int i_b, int i_t, const std::string & i_mode, bool i_binary) const
@@ -1401,6 +1469,21 @@ void JobAf::v_getTaskOutput( af::MCTask & io_mctask, std::string & o_error) cons
 	m_blocks[b]->m_tasks[t]->getOutput( io_mctask, o_error);
 }
 
+int64_t JobAf::setModified()
+{
+	if( NULL == ms_jobs )
+		return 0;
+
+	m_modified_gen = ms_jobs->incModifiedGen();
+
+	return m_modified_gen;
+}
+
+void JobAf::setAdded()
+{
+	m_added_gen = setModified();
+}
+
 void JobAf::fillTaskNames( af::MCTask & o_mctask) const
 {
 	int b = o_mctask.getBlockNum();
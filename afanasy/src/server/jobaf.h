@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../libafanasy/name_af.h"
+#include "../libafanasy/idcounters.h"
 #include "../libafanasy/job.h"
 #include "../libafanasy/msgclasses/mctask.h"
 #include "../libafanasy/msgclasses/mctaskup.h"
@@ -8,6 +9,7 @@
 #include "../libafanasy/msgclasses/mcgeneral.h"
 
 #include "afnodesolve.h"
+#include "taskprogresslog.h"
 
 class Action;
 class Block;
@@ -86,6 +88,7 @@ public:
 	virtual void v_action( Action & i_action);
 
 	void setUser( UserAf * i_user);
+	inline const UserAf * getUser() const { return m_user; }
 
 	/// Initialize new job, came to Afanasy container.
 	bool initialize();
@@ -107,12 +110,30 @@ public:
 
 	const std::string & getTasksDir() const { return m_store_dir_tasks; }
 
+	/// Store task progress in job tasks progress log.
+	inline void storeTaskProgress( int i_block, int i_task) { m_tasks_progress_log.append( i_block, i_task, m_progress); }
+
+	/// Whether task progress was read from job tasks progress log (on job construction from store).
+	inline bool isTaskProgressLoaded( int i_block, int i_task) const { return m_tasks_progress_log.isLoaded( i_block, i_task); }
+	inline void taskProgressReadFromFolder() { m_tasks_progress_log.setFolderRead(); }
+
 	void setThumbnail( const std::string & i_path, int i_size, const char * i_data );
 	inline bool hasThumbnail() const { return m_thumb_size > 0; }
 
 	/// Just fill in job, block, task and other names:
 	void fillTaskNames( af::MCTask & o_mctask) const;
 
+	/// Mark job changed for jobs delta lists, returns modification generation.
+	int64_t setModified();
+
+	/// Mark job just added to container, its all blocks and tasks are new for clients.
+	void setAdded();
+
+	inline int64_t getModifiedGen() const { return m_modified_gen; }
+
+	/// Write tasks progress changed after client generation (JSON).
+	af::Msg * writeProgressDelta( int64_t i_since) const;
+
 public:
 	/// Set Jobs Container.
 	inline static void setJobContainer( JobContainer *Jobs){ ms_jobs = Jobs;}
@@ -134,16 +155,24 @@ protected:
 private:
 	bool m_deletion; ///< Whether the job is deleting.
 
-	std::list<RenderAf*> renders_ptrs;
-	std::list<int> renders_counts;
+	af::IdCounters m_renders_counts; ///< Running tasks number per render id.
 
 	UserAf * m_user;
 
 	std::string m_store_dir_tasks; ///< Tasks store directory.
 
+	TaskProgressLog m_tasks_progress_log;
+	bool m_tasks_progress_log_read; ///< Whether job was read from store with tasks progress log.
+
 	bool m_thumb_changed; ///< Store that thumbnail was changed, to emit event for monitors
 	bool m_report_changed; ///< Store that thumbnail was changed, to emit event for monitors
 
+	/// Incremented on each solve on render, tasks store it when they was tried to generate.
+	uint32_t m_solve_epoch;
+
+	int64_t m_modified_gen; ///< Generation of the last job, its blocks or tasks change.
+	int64_t m_added_gen;    ///< Generation when job was added to container.
+
 private:
 	mutable int progressWeight;
 	mutable int m_logsWeight;
@@ -4,10 +4,13 @@
 #include <string.h>
 #include <memory.h>
 
+#include "../libafanasy/common/dlScopeLocker.h"
 #include "../libafanasy/environment.h"
+#include "../libafanasy/msgstream.h"
 #include "../libafanasy/msgclasses/mcafnodes.h"
 
 #include "afcommon.h"
+#include "aflist.h"
 #include "useraf.h"
 #include "usercontainer.h"
 #include "rendercontainer.h"
@@ -18,10 +21,18 @@
 #include "../include/macrooutput.h"
 #include "../libafanasy/logger.h"
 
+// Number of deleted jobs ids to keep for jobs delta lists.
+static const int DeletedJobsKeep = 10000;
+
 JobContainer::JobContainer():
     AfContainer( "Jobs", AFJOB::MAXQUANTITY)
 {
 	JobAf::setJobContainer( this);
+
+	// Generation starts from the server start time,
+	// so a generation that client got from a previous server run is older.
+	m_modified_gen = int64_t( time( NULL)) * 1000000;
+	m_deleted_horizon = m_modified_gen;
 }
 
 JobContainer::~JobContainer()
@@ -152,6 +163,7 @@ bool JobContainer::registerJob( JobAf *job, std::string & o_err, UserContainer *
 			o_err = "JobContainer::registerJob: Can't add job to container.";
 			return false;
 		}
+		job->setAdded();
 		AF_DEBUG << "JobContainer::registerJob: locking job.";
 		job->lock();
 
@@ -206,6 +218,7 @@ bool JobContainer::registerJob( JobAf *job, std::string & o_err, UserContainer *
 		AfContainerLock uLock( users, AfContainerLock::WRITELOCK);
 		user->unLock();
 		job->unLock();
+		job->setModified();
 	}
 
 	AFCommon::QueueLog("Job registered: " + job->v_generateInfoString());
@@ -213,6 +226,111 @@ bool JobContainer::registerJob( JobAf *job, std::string & o_err, UserContainer *
 	return true;
 }
 
+int64_t JobContainer::incModifiedGen()
+{
+	DlScopeLocker lock( &m_modified_mutex);
+	return ++m_modified_gen;
+}
+
+int64_t JobContainer::getModifiedGen()
+{
+	DlScopeLocker lock( &m_modified_mutex);
+	return m_modified_gen;
+}
+
+void JobContainer::jobDeleted( int32_t i_id)
+{
+	DlScopeLocker lock( &m_modified_mutex);
+
+	m_deleted_ids.push_back( i_id);
+	m_deleted_gens.push_back( ++m_modified_gen);
+
+	if( m_deleted_ids.size() > DeletedJobsKeep )
+	{
+		m_deleted_horizon = m_deleted_gens.front();
+		m_deleted_ids.pop_front();
+		m_deleted_gens.pop_front();
+	}
+}
+
+bool JobContainer::isDeltaFull( int64_t i_since)
+{
+	DlScopeLocker lock( &m_modified_mutex);
+	return ( i_since < m_deleted_horizon ) || ( i_since > m_modified_gen );
+}
+
+af::Msg * JobContainer::generateDelta( int64_t i_since, const std::vector<int32_t> & i_uids, UserContainer * i_users)
+{
+	int64_t generation;
+	bool full;
+	std::vector<int32_t> deleted;
+	{
+		DlScopeLocker lock( &m_modified_mutex);
+		generation = m_modified_gen;
+		full = ( i_since < m_deleted_horizon ) || ( i_since > m_modified_gen );
+		if( false == full )
+		{
+			std::list<int32_t>::const_reverse_iterator iIt = m_deleted_ids.rbegin();
+			std::list<int64_t>::const_reverse_iterator gIt = m_deleted_gens.rbegin();
+			for( ; ( gIt != m_deleted_gens.rend()) && ( *gIt > i_since ); iIt++, gIt++)
+				deleted.push_back( *iIt);
+		}
+	}
+
+	// Jobs are collected in users order if users are specified.
+	std::vector<JobAf*> jobs;
+	if( i_uids.size())
+	{
+		UserContainerIt usersIt( i_users);
+		for( int u = 0; u < i_uids.size(); u++)
+		{
+			UserAf * user = usersIt.getUser( i_uids[u]);
+			if( NULL == user ) continue;
+			AfListIt jobsIt( user->getJobsList());
+			for( AfNodeSolve * node = jobsIt.node(); node != NULL; jobsIt.next(), node = jobsIt.node())
+				jobs.push_back( (JobAf*)( node));
+		}
+	}
+	else
+	{
+		JobContainerIt jobsIt( this);
+		for( JobAf * job = jobsIt.job(); job != NULL; jobsIt.next(), job = jobsIt.job())
+			jobs.push_back( job);
+	}
+
+	af::MsgStream str;
+	str << "{\"jobs\":[\n";
+	bool added = false;
+	for( int j = 0; j < jobs.size(); j++)
+	{
+		if(( false == full ) && ( jobs[j]->getModifiedGen() <= i_since ))
+			continue;
+
+		if( added )
+			str << ",\n";
+		jobs[j]->v_jsonWrite( str, af::Msg::TJobsList);
+		added = true;
+	}
+	str << "\n],\n\"ids\":[";
+	for( int j = 0; j < jobs.size(); j++)
+	{
+		if( j ) str << ",";
+		str << jobs[j]->getId();
+	}
+	str << "],\n\"deleted\":[";
+	for( int d = 0; d < deleted.size(); d++)
+	{
+		if( d ) str << ",";
+		str << deleted[d];
+	}
+	str << "],\n\"generation\":" << generation;
+	if( full )
+		str << ",\n\"full\":true";
+	str << "\n}";
+
+	return str.generateMsg();
+}
+
 const std::vector<int32_t> JobContainer::getIdsBySerials( const std::vector<int64_t> & i_serials)
 {
 	std::vector<int32_t> ids;
@@ -2,6 +2,7 @@
 
 #include "../include/afjob.h"
 
+#include "../libafanasy/common/dlMutex.h"
 #include "../libafanasy/msgclasses/mcgeneral.h"
 #include "../libafanasy/msgclasses/mcjobsweight.h"
 
@@ -9,6 +10,7 @@
 
 #include "afcontainer.h"
 #include "afcontainerit.h"
+#include "dependindex.h"
 #include "jobaf.h"
 
 class MsgAf;
@@ -41,6 +43,36 @@ public:
 	const std::vector<int32_t> getIdsBySerials( const std::vector<int64_t> & i_serials);
 
 	void getWeight( af::MCJobsWeight & jobsWeight );
+
+	inline DependIndex & getDependIndex() { return m_depend_index; }
+
+	/// Increment jobs modification generation, can be called from any thread.
+	/** Jobs, blocks and tasks store a generation of their last change, for jobs delta lists. **/
+	int64_t incModifiedGen();
+
+	int64_t getModifiedGen();
+
+	/// Store deleted job id for jobs delta lists.
+	void jobDeleted( int32_t i_id);
+
+	/// Whether changes since client generation are not known and client needs all nodes.
+	/** Generation can be too old, so deleted jobs are forgotten, or from a previous server run. **/
+	bool isDeltaFull( int64_t i_since);
+
+	/// Generate jobs list delta (JSON): jobs changed after client generation, deleted and all jobs ids.
+	/** If uids are not empty, only jobs of these users are listed. **/
+	af::Msg * generateDelta( int64_t i_since, const std::vector<int32_t> & i_uids, UserContainer * i_users);
+
+private:
+	DependIndex m_depend_index;
+
+	DlMutex m_modified_mutex;
+	int64_t m_modified_gen;
+
+	/// Deleted jobs ids and generations, older deletions are forgotten.
+	std::list<int32_t> m_deleted_ids;
+	std::list<int64_t> m_deleted_gens;
+	int64_t m_deleted_horizon; ///< Deletions before this generation are forgotten.
 };
 
 //########################## Iterator ##############################
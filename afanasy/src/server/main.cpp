@@ -16,8 +16,11 @@
 #include "jobcontainer.h"
 #include "monitorcontainer.h"
 #include "socketsprocessing.h"
+#include "storeloader.h"
 #include "sysjob.h"
 #include "rendercontainer.h"
+#include "renderheartbeats.h"
+#include "runcycle.h"
 #include "threadargs.h"
 #include "usercontainer.h"
 
@@ -119,6 +122,7 @@ int main(int argc, char *argv[])
 
 	RenderContainer renders;
 	if( false == renders.isInitialized()) return 1;
+	RenderHeartbeats::Init();
 
 	MonitorContainer monitors;
 	if( false == monitors.isInitialized()) return 1;
@@ -149,6 +153,9 @@ int main(int argc, char *argv[])
 		afdb_upTables.DBClose();
 	}
 
+	int64_t store_time_start = RunCycle::NowMSec();
+	int64_t store_time_renders, store_time_users, store_time_jobs_read, store_time_jobs_register;
+
 	//
 	// Get Renders from store:
 	//
@@ -170,6 +177,7 @@ int main(int argc, char *argv[])
 		renders.addRender( render, NULL, NULL);
 	}
 	AF_LOG << renders.getCount() << " renders registered.";
+	store_time_renders = RunCycle::NowMSec();
 	}
 
 	//
@@ -194,6 +202,7 @@ int main(int argc, char *argv[])
 			delete user;
 	}
 	AF_LOG << users.getCount() << " users registered from store.";
+	store_time_users = RunCycle::NowMSec();
 	}
 	//
 	// Get Jobs from store:
@@ -206,14 +215,28 @@ int main(int argc, char *argv[])
 	std::string sysjob_folder = AFCommon::getStoreDir( ENV.getStoreFolderJobs(), AFJOB::SYSJOB_ID, AFJOB::SYSJOB_NAME);
 
 	AF_LOG << folders.size() << " jobs found.";
+
+	// System job is constructed here, as its virtual functions are needed for store reading,
+	// all other jobs are read in parallel.
+	std::vector<std::string> jobs_folders;
+	jobs_folders.reserve( folders.size());
 	for( int i = 0; i < folders.size(); i++)
+		if( folders[i] != sysjob_folder )
+			jobs_folders.push_back( folders[i]);
+
+	std::vector<JobAf*> jobs_read;
+	StoreLoader::LoadJobs( jobs_folders, jobs_read);
+	store_time_jobs_read = RunCycle::NowMSec();
+
+	// Jobs are registered in the store folders order:
+	for( int i = 0, r = 0; i < folders.size(); i++)
 	{
 		JobAf * job = NULL;
 
 		if( folders[i] == sysjob_folder)
 			job = new SysJob( folders[i]);
 		else
-			job = new JobAf( folders[i]);
+			job = jobs_read[r++];
 
 		if( job->isValidConstructed())
 		{
@@ -244,8 +267,15 @@ int main(int argc, char *argv[])
 		}
 	}
 	AF_LOG << jobs.getCount() << " jobs registered from store.";
+	store_time_jobs_register = RunCycle::NowMSec();
 	}
 
+	AF_LOG << "Store loaded in " << store_time_jobs_register - store_time_start << " msec:"
+		<< " renders " << store_time_renders - store_time_start
+		<< ", users " << store_time_users - store_time_renders
+		<< ", jobs read " << store_time_jobs_read - store_time_users
+		<< ", jobs register " << store_time_jobs_register - store_time_jobs_read;
+
 	// Disable new commands and editing:
 	if( af::Environment::hasArgument("-demo"))
 	{
@@ -276,6 +306,7 @@ int main(int argc, char *argv[])
 
 	// Run cycle thread.
 	// All 'brains' are there.
+	RunCycle::Init();
 	DlThread RunCycleThread;
 	RunCycleThread.Start( &threadRunCycle, &threadArgs);
 
@@ -294,11 +325,15 @@ int main(int argc, char *argv[])
 	//ServerAccept.Join();
 
 	// No need to chanel run cycle thread as
-	// every new cycle it checks running external valiable
+	// every new cycle it checks running external valiable,
+	// just wake it up not to wait for the maximum cycle period.
+	RunCycle::Destroy();
 	RunCycleThread.Join();
 
 	delete socketsProcessing;
 
+	RenderHeartbeats::Destroy();
+
 	af::destroy();
 
 	AF_LOG << "Exiting process...";
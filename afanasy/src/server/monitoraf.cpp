@@ -4,6 +4,7 @@
 
 #include "../libafanasy/environment.h"
 #include "../libafanasy/monitorevents.h"
+#include "../libafanasy/msgstream.h"
 
 #include "action.h"
 #include "afcommon.h"
@@ -254,6 +255,17 @@ void MonitorAf::addEvents( int i_type, const std::list<int32_t> & i_ids)
 //printf("MonitorAf::addEvents: i_ids.size()=%lu\n", i_ids.size());
 }
 
+void MonitorAf::addEvent( int i_type, int32_t i_id)
+{
+	if(( i_type >= af::Monitor::EVT_COUNT ) || ( i_type < 0 ))
+	{
+		AFERRAR("MonitorAf::addEvent: Event %d is invalid.", i_type)
+		return;
+	}
+
+	af::addUniqueToVect( m_e.m_events[i_type], i_id);
+}
+
 void MonitorAf::addTaskProgress( int i_j, int i_b, int i_t, const af::TaskProgress * i_tp)
 {
 //std::ostringstream str;af::jw_state( i_tp->state, str);printf("MonitorAf::addTaskProgress():j=%d b=%d t=%d s='%s'\n", i_j, i_b, i_t, str.str().c_str());
@@ -398,50 +410,43 @@ bool MonitorAf::isListening( const af::MCTask & i_mctask) const
 	return false;
 }
 
-af::Msg * MonitorAf::getEventsBin()
+void MonitorAf::takeEvents( af::MonitorEvents & o_events)
 {
 	updateTime();
 
 	DlScopeLocker mutex( &m_mutex);
 
-	af::Msg * msg = NULL;
-
-	if( m_e.isEmpty())
-		msg = new af::Msg( af::Msg::TMonitorId, getId());
-	else
-	{
-		prepareEvents();
-		msg = new af::Msg( af::Msg::TMonitorEvents, &m_e);
-	}
+	prepareEvents();
 
+	o_events.swap( m_e);
 	m_e.clear();
+}
 
-	return msg;
+bool MonitorAf::hasEvents()
+{
+	DlScopeLocker mutex( &m_mutex);
+
+	return false == m_e.isEmpty();
 }
 
-af::Msg * MonitorAf::getEventsJSON()
+af::Msg * MonitorAf::EventsBin( int i_id, af::MonitorEvents & i_events)
 {
-	updateTime();
+	if( i_events.isEmpty())
+		return new af::Msg( af::Msg::TMonitorId, i_id);
 
-	af::Msg * msg = new af::Msg();
+	return new af::Msg( af::Msg::TMonitorEvents, &i_events);
+}
 
-	std::ostringstream stream;
+af::Msg * MonitorAf::EventsJSON( af::MonitorEvents & i_events)
+{
+	af::MsgStream stream;
 	stream << "{\"events\":";
 
-	DlScopeLocker mutex( &m_mutex);
-
-	prepareEvents();
-	m_e.jsonWrite( stream);
+	i_events.jsonWrite( stream);
 
 	stream << "\n}";
 
-//if( hasevents ) printf("MonitorAf::getEvents():\n%s\n", stream.str().c_str());
-
-	msg->setData( stream.str().size(), stream.str().c_str(), af::Msg::TJSON);
-
-	m_e.clear();
-
-	return msg;
+	return stream.generateMsg();
 }
 
 void MonitorAf::prepareEvents()
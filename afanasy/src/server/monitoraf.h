@@ -33,9 +33,17 @@ public:
 	static void setMonitorContainer( MonitorContainer * i_monitors) { m_monitors = i_monitors;}
 
 	void addEvents( int i_type, const std::list<int32_t> & i_ids);
+	void addEvent( int i_type, int32_t i_id);
 
-	af::Msg * getEventsBin();
-	af::Msg * getEventsJSON();
+	/// Take accumulated events, monitors container should be locked.
+	/** Events are serialized later, without container lock. **/
+	void takeEvents( af::MonitorEvents & o_events);
+
+	/// Whether there are events to take, to answer a waiting events request.
+	bool hasEvents();
+
+	static af::Msg * EventsBin( int i_id, af::MonitorEvents & i_events);
+	static af::Msg * EventsJSON( af::MonitorEvents & i_events);
 
 	void addTaskProgress( int i_j, int i_b, int i_t, const af::TaskProgress * i_tp);
 
@@ -3,6 +3,8 @@
 #include "../include/afanasy.h"
 
 #include "../libafanasy/blockdata.h"
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/environment.h"
 #include "../libafanasy/job.h"
 #include "../libafanasy/msgclasses/mcgeneral.h"
 #include "../libafanasy/msgclasses/mctaskpos.h"
@@ -12,6 +14,8 @@
 #include "afcommon.h"
 #include "renderaf.h"
 #include "rendercontainer.h"
+#include "runcycle.h"
+#include "socketsprocessing.h"
 #include "useraf.h"
 
 #define AFOUTPUT
@@ -23,13 +27,17 @@ MonitorContainer::MonitorContainer():
 	AfContainer( "Monitors", AFMONITOR::MAXCOUNT),
 	m_events( NULL),
 	m_jobEvents( NULL),
-	m_jobEventsUids( NULL)
+	m_jobEventsUids( NULL),
+	m_subscriptions_changed( true)
 {
 	MonitorAf::setMonitorContainer( this);
 
 	m_events = new std::list<int32_t>[ af::Monitor::EVT_COUNT];
 	m_jobEvents	  = new std::list<int32_t>[ af::Monitor::EVT_JOBS_COUNT];
 	m_jobEventsUids = new std::list<int32_t>[ af::Monitor::EVT_JOBS_COUNT];
+
+	for( int i = 0; i < GEN_COUNT; i++)
+		m_generations[i] = 0;
 AFINFA("MonitorContainer::MonitorContainer: Events Count = %d, Job Events = %d\n", af::Monitor::EVT_COUNT, af::Monitor::EVT_JOBS_COUNT);
 }
 
@@ -73,6 +81,21 @@ void MonitorContainer::addEvent( int i_type, int i_nodeId)
 	}
 
 	af::addUniqueToList( m_events[i_type], i_nodeId);
+
+	if( i_type >= af::Monitor::EVT_monitors_add )
+		incGeneration( GEN_monitors);
+	else if( i_type >= af::Monitor::EVT_renders_add )
+		incGeneration( GEN_renders);
+	else if( i_type >= af::Monitor::EVT_users_add )
+		incGeneration( GEN_users);
+	else
+		incGeneration( GEN_jobs);
+
+	// Any monitor add, change or delete can change subscriptions.
+	if(( i_type == af::Monitor::EVT_monitors_add ) ||
+		( i_type == af::Monitor::EVT_monitors_change ) ||
+		( i_type == af::Monitor::EVT_monitors_del ))
+		m_subscriptions_changed = true;
 }
 
 void MonitorContainer::addJobEvent( int i_type, int i_jid, int i_uid)
@@ -85,6 +108,27 @@ void MonitorContainer::addJobEvent( int i_type, int i_jid, int i_uid)
 
 	if( af::addUniqueToList( m_jobEvents[i_type], i_jid))
 		m_jobEventsUids[i_type].push_back( i_uid);
+
+	incGeneration( GEN_jobs);
+}
+
+void MonitorContainer::incGeneration( int i_gen)
+{
+	DlScopeLocker lock( &m_generations_mutex);
+	m_generations[i_gen]++;
+}
+
+int64_t MonitorContainer::getGeneration( const std::string & i_type)
+{
+	int gen;
+	if     ( i_type == "jobs"     ) gen = GEN_jobs;
+	else if( i_type == "users"    ) gen = GEN_users;
+	else if( i_type == "renders"  ) gen = GEN_renders;
+	else if( i_type == "monitors" ) gen = GEN_monitors;
+	else return -1;
+
+	DlScopeLocker lock( &m_generations_mutex);
+	return m_generations[gen];
 }
 
 void MonitorContainer::outputsReceived( const std::vector<af::MCTaskPos> & i_outspos, const std::vector<std::string> & i_outputs)
@@ -124,8 +168,46 @@ void MonitorContainer::addListened( const af::MCTask & i_mctask)
 	m_listens.push_back( i_mctask);
 }
 
+void MonitorContainer::buildSubscriptions()
+{
+	m_subscribed_events.assign( af::Monitor::EVT_COUNT, std::vector<MonitorAf*>());
+	m_subscribed_job_events.assign( af::Monitor::EVT_JOBS_COUNT, std::map<int32_t, std::vector<MonitorAf*> >());
+	m_subscribed_job_events_all.assign( af::Monitor::EVT_JOBS_COUNT, std::vector<MonitorAf*>());
+	m_subscribed_jobs.clear();
+	m_subscribed_uids.clear();
+
+	MonitorContainerIt monitorsIt( this);
+	for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
+	{
+		for( int e = 0; e < af::Monitor::EVT_COUNT; e++)
+			if( monitor->hasEvent( e))
+				m_subscribed_events[e].push_back( monitor);
+
+		// Zero uid monitor receives job events of all users.
+		for( int e = 0; e < af::Monitor::EVT_JOBS_COUNT; e++)
+			if( monitor->hasEvent( e))
+			{
+				if( monitor->getUid() == 0 )
+					m_subscribed_job_events_all[e].push_back( monitor);
+				else
+					m_subscribed_job_events[e][monitor->getUid()].push_back( monitor);
+			}
+
+		const std::list<int32_t> * jids = monitor->getJobsIds();
+		for( std::list<int32_t>::const_iterator it = jids->begin(); it != jids->end(); it++)
+			m_subscribed_jobs[*it].push_back( monitor);
+
+		m_subscribed_uids[monitor->getUid()].push_back( monitor);
+	}
+
+	m_subscriptions_changed = false;
+}
+
 void MonitorContainer::dispatch( RenderContainer * i_renders)
 {
+	if( m_subscriptions_changed )
+		buildSubscriptions();
+
 	//
 	// Common Events:
 	//
@@ -133,10 +215,8 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 	{
 		if( m_events[e].size() < 1) continue;
 
-		MonitorContainerIt monitorsIt( this);
-		for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
-			if( monitor->hasEvent( e))
-				monitor->addEvents( e, m_events[e]);
+		for( int m = 0; m < m_subscribed_events[e].size(); m++)
+			m_subscribed_events[e][m]->addEvents( e, m_events[e]);
 	}
 
 
@@ -154,29 +234,23 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 			continue;
 		}
 
-		MonitorContainerIt monitorsIt( this);
-		for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
-		{
-			std::list<int32_t> ids;
-			bool found = false;
+		const std::vector<MonitorAf*> & all = m_subscribed_job_events_all[e];
+		for( int m = 0; m < all.size(); m++)
+			all[m]->addEvents( e, m_jobEvents[e]);
 
-			std::list<int32_t>::const_iterator jIt = m_jobEvents[e].begin();
-			std::list<int32_t>::const_iterator jIt_end = m_jobEvents[e].end();
-			std::list<int32_t>::const_iterator uIt = m_jobEventsUids[e].begin();
+		if( m_subscribed_job_events[e].empty())
+			continue;
 
-			while( jIt != jIt_end)
-			{
-				if( monitor->hasJobEvent( e, *uIt))
-				{
-					if( !found) found = true;
-						ids.push_back( *jIt);
-				}
-				jIt++;
-				uIt++;
-			}
-			if( ! found ) continue;
+		std::list<int32_t>::const_iterator jIt = m_jobEvents[e].begin();
+		std::list<int32_t>::const_iterator uIt = m_jobEventsUids[e].begin();
+		for( ; jIt != m_jobEvents[e].end(); jIt++, uIt++)
+		{
+			std::map<int32_t, std::vector<MonitorAf*> >::const_iterator it = m_subscribed_job_events[e].find( *uIt);
+			if( it == m_subscribed_job_events[e].end())
+				continue;
 
-			monitor->addEvents( e, ids);
+			for( int m = 0; m < it->second.size(); m++)
+				it->second[m]->addEvent( e, *jIt);
 		}
 	}
 
@@ -185,39 +259,41 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 	// Tasks progress events:
 	//
 	std::list<af::MCTasksProgress*>::const_iterator tIt = m_tasks.begin();
-	while( tIt != m_tasks.end())
+	for( ; tIt != m_tasks.end(); tIt++)
 	{
-		MonitorContainerIt monitorsIt( this);
-		for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
+		std::map<int32_t, std::vector<MonitorAf*> >::const_iterator it = m_subscribed_jobs.find( (*tIt)->getJobId());
+		if( it == m_subscribed_jobs.end())
+			continue;
+
+		for( int m = 0; m < it->second.size(); m++)
 		{
-			if( monitor->hasJobId( (*tIt)->getJobId()))
+			MonitorAf * monitor = it->second[m];
+			const std::list<af::TaskProgress*> * progresses  = (*tIt)->getTasksRun();
+			std::list<int32_t>::const_iterator blocksIt = (*tIt)->getBlocks()->begin();
+			std::list<int32_t>::const_iterator tasksIt = (*tIt)->getTasks()->begin();
+			std::list<af::TaskProgress*>::const_iterator progressIt = progresses->begin();
+			while( progressIt != progresses->end())
 			{
-				const std::list<af::TaskProgress*> * progresses  = (*tIt)->getTasksRun();
-				std::list<int32_t>::const_iterator blocksIt = (*tIt)->getBlocks()->begin();
-				std::list<int32_t>::const_iterator tasksIt = (*tIt)->getTasks()->begin();
-				std::list<af::TaskProgress*>::const_iterator progressIt = progresses->begin();
-				while( progressIt != progresses->end())
-				{
-					monitor->addTaskProgress( (*tIt)->getJobId(), *blocksIt, *tasksIt, *progressIt);
-					blocksIt++; tasksIt++; progressIt++;
-				}
+				monitor->addTaskProgress( (*tIt)->getJobId(), *blocksIt, *tasksIt, *progressIt);
+				blocksIt++; tasksIt++; progressIt++;
 			}
 		}
-		tIt++;
 	}
 
 	//
 	// Blocks changed:
 	//
 	{
-	MonitorContainerIt monitorsIt( this);
-	for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
+	std::list<af::BlockData*>::iterator bIt = m_blocks.begin();
+	std::list<int32_t>::iterator tIt = m_blocks_types.begin();
+	for( ; bIt != m_blocks.end(); bIt++, tIt++)
 	{
-		std::list<af::BlockData*>::iterator bIt = m_blocks.begin();
-		std::list<int32_t>::iterator tIt = m_blocks_types.begin();
-		for( ; bIt != m_blocks.end(); bIt++, tIt++)
-			if( monitor->hasJobId( (*bIt)->getJobId()))
-				monitor->addBlock( (*bIt)->getJobId(), (*bIt)->getBlockNum(), *tIt);
+		std::map<int32_t, std::vector<MonitorAf*> >::const_iterator it = m_subscribed_jobs.find( (*bIt)->getJobId());
+		if( it == m_subscribed_jobs.end())
+			continue;
+
+		for( int m = 0; m < it->second.size(); m++)
+			it->second[m]->addBlock( (*bIt)->getJobId(), (*bIt)->getBlockNum(), *tIt);
 	}
 	}
 
@@ -226,15 +302,16 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 	//
 	{
 	std::list<UserAf*>::iterator uIt = m_usersJobOrderChanged.begin();
-	while( uIt != m_usersJobOrderChanged.end())
+	for( ; uIt != m_usersJobOrderChanged.end(); uIt++)
 	{
+		std::map<int32_t, std::vector<MonitorAf*> >::const_iterator it = m_subscribed_uids.find((*uIt)->getId());
+		if( it == m_subscribed_uids.end())
+			continue;
+
 		std::vector<int32_t> jids = (*uIt)->generateJobsIds();
 
-		MonitorContainerIt monitorsIt( this);
-		for( MonitorAf * monitor = monitorsIt.monitor(); monitor != NULL; monitorsIt.next(), monitor = monitorsIt.monitor())
-			if( monitor->sameUid((*uIt)->getId()))
-				monitor->setUserJobsOrder( jids);
-		uIt++;
+		for( int m = 0; m < it->second.size(); m++)
+			it->second[m]->setUserJobsOrder( jids);
 	}
 	}
 
@@ -282,6 +359,98 @@ void MonitorContainer::dispatch( RenderContainer * i_renders)
 	// Delete all events:
 	//
 	clearEvents();
+
+	//
+	// Answer monitors waiting for events:
+	//
+	processWaiting();
+}
+
+void MonitorContainer::waitEvents( int i_id, SocketItem * i_si, bool i_json)
+{
+	Waiting waiting;
+	waiting.si = i_si;
+	waiting.json = i_json;
+	waiting.wait_until = RunCycle::NowMSec() + 1000 * af::Environment::getMonitorEventsWaitSec();
+
+	Waiting replaced;
+	replaced.si = NULL;
+	{
+		DlScopeLocker lock( &m_waiting_mutex);
+
+		std::map<int32_t, Waiting>::iterator it = m_waiting.find( i_id);
+		if( it != m_waiting.end())
+		{
+			// Previous request can be left from a lost connection.
+			replaced = it->second;
+			it->second = waiting;
+		}
+		else
+			m_waiting[i_id] = waiting;
+	}
+
+	if( replaced.si )
+	{
+		af::MonitorEvents events;
+		if( replaced.json )
+			SocketsProcessing::AnswerWaiting( replaced.si, MonitorAf::EventsJSON( events));
+		else
+			SocketsProcessing::AnswerWaiting( replaced.si, MonitorAf::EventsBin( i_id, events));
+	}
+}
+
+void MonitorContainer::processWaiting()
+{
+	// Waiting requests are not answered here, but processed again by a processing thread.
+	// So events are taken and serialized as usual, without run thread.
+	// Events are accumulated by monitor while its request is not processed,
+	// so a slow client receives all of them merged in the next answer.
+	std::vector<SocketItem*> wake;
+	std::vector<Waiting> timedout;
+	std::vector<int32_t> timedout_ids;
+
+	int64_t now = RunCycle::NowMSec();
+
+	{
+		DlScopeLocker lock( &m_waiting_mutex);
+
+		MonitorContainerIt monitorsIt( this);
+		std::map<int32_t, Waiting>::iterator it = m_waiting.begin();
+		while( it != m_waiting.end())
+		{
+			MonitorAf * monitor = monitorsIt.getMonitor( it->first);
+
+			// Request of a deleted monitor is processed again to answer that there is no such monitor.
+			if(( NULL == monitor ) || monitor->hasEvents())
+			{
+				wake.push_back( it->second.si);
+			}
+			else if( now >= it->second.wait_until )
+			{
+				timedout.push_back( it->second);
+				timedout_ids.push_back( it->first);
+			}
+			else
+			{
+				it++;
+				continue;
+			}
+
+			m_waiting.erase( it++);
+		}
+	}
+
+	for( int i = 0; i < wake.size(); i++)
+		SocketsProcessing::ProcessAgain( wake[i]);
+
+	for( int i = 0; i < timedout.size(); i++)
+	{
+		af::MonitorEvents events;
+		if( timedout[i].json )
+			SocketsProcessing::AnswerWaiting( timedout[i].si, MonitorAf::EventsJSON( events));
+		else
+			SocketsProcessing::AnswerWaiting( timedout[i].si, MonitorAf::EventsBin( timedout_ids[i], events));
+	}
 }
 
 void MonitorContainer::clearEvents()
@@ -335,10 +504,14 @@ void MonitorContainer::addTask( int i_jobid, int i_block, int i_task, af::TaskPr
 	}
 
 	t->add( i_block, i_task, i_tp);
+
+	incGeneration( GEN_jobs);
 }
 
 void MonitorContainer::addBlock( int i_type, af::BlockData * i_block)
 {
+	incGeneration( GEN_jobs);
+
 	std::list<af::BlockData*>::const_iterator bIt = m_blocks.begin();
 	std::list<int32_t>::iterator tIt = m_blocks_types.begin();
 	for( ; bIt != m_blocks.end(); bIt++, tIt++)
@@ -357,6 +530,10 @@ void MonitorContainer::addBlock( int i_type, af::BlockData * i_block)
 
 void MonitorContainer::addUser( UserAf * i_user)
 {
+	// Jobs order is a part of user jobs list.
+	incGeneration( GEN_jobs);
+	incGeneration( GEN_users);
+
 	std::list<UserAf*>::const_iterator uIt = m_usersJobOrderChanged.begin();
 	while( uIt != m_usersJobOrderChanged.end())
 		if( *(uIt++) == i_user)
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <map>
+
 #include "afcontainer.h"
 #include "afcontainerit.h"
 
+#include "../libafanasy/common/dlMutex.h"
 #include "../libafanasy/monitorevents.h"
 #include "../libafanasy/taskprogress.h"
 
@@ -10,6 +13,7 @@
 
 class MonitorAf;
 class RenderContainer;
+class SocketItem;
 class UserAf;
 
 /// Monitors container.
@@ -42,6 +46,15 @@ public:
 
    void dispatch( RenderContainer * i_renders);
 
+	/// Hold monitor events request until events are dispatched, can be called from any thread.
+	/** Request is processed again when monitor has events, or answered with no events on wait timeout. **/
+	void waitEvents( int i_id, SocketItem * i_si, bool i_json);
+
+	/// Nodes change generation, it is incremented on any event of "jobs", "users", "renders" or "monitors" nodes.
+	/** Can be called from any thread, used to check that a cached list response is still valid.
+	*** Returns -1 for unknown nodes type. **/
+	int64_t getGeneration( const std::string & i_type);
+
 private:
 
 	std::list<int32_t> * m_events;
@@ -61,6 +74,57 @@ private:
 	std::string m_announcement;
 
    void clearEvents();
+
+	/// Build subscriptions indexes, so each event is delivered to subscribed monitors only.
+	void buildSubscriptions();
+
+	/// Wake waiting requests of monitors that have events, answer timed out (run thread only).
+	void processWaiting();
+
+	void incGeneration( int i_gen);
+
+private:
+	enum Generations
+	{
+		GEN_jobs,
+		GEN_users,
+		GEN_renders,
+		GEN_monitors,
+		GEN_COUNT
+	};
+
+	int64_t m_generations[GEN_COUNT];
+	DlMutex m_generations_mutex;
+
+	/// Monitor events request, waiting for events.
+	struct Waiting
+	{
+		SocketItem * si;
+		bool json;
+		int64_t wait_until;
+	};
+
+	/// Monitor id -> waiting request, a monitor waits only once.
+	std::map<int32_t, Waiting> m_waiting;
+	DlMutex m_waiting_mutex;
+
+	/// Monitors added, deleted or changed subscriptions, indexes should be rebuilt.
+	bool m_subscriptions_changed;
+
+	/// Event type -> subscribed monitors.
+	std::vector<std::vector<MonitorAf*> > m_subscribed_events;
+
+	/// Job event type -> user id -> subscribed monitors.
+	std::vector<std::map<int32_t, std::vector<MonitorAf*> > > m_subscribed_job_events;
+
+	/// Job event type -> subscribed monitors of all users (super users).
+	std::vector<std::vector<MonitorAf*> > m_subscribed_job_events_all;
+
+	/// Job id -> monitors watching job tasks.
+	std::map<int32_t, std::vector<MonitorAf*> > m_subscribed_jobs;
+
+	/// User id -> monitors.
+	std::map<int32_t, std::vector<MonitorAf*> > m_subscribed_uids;
 };
 
 /// Monitors iterator.
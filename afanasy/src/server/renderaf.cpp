@@ -11,6 +11,7 @@
 #include "jobcontainer.h"
 #include "monitorcontainer.h"
 #include "rendercontainer.h"
+#include "renderheartbeats.h"
 #include "sysjob.h"
 
 #define AFOUTPUT
@@ -95,6 +96,9 @@ void RenderAf::setRegistered()
 
 	af::Client::setRegisterTime();
 
+	if( isOnline())
+		RenderHeartbeats::SetOnline( m_id, true);
+
 	m_task_start_finish_time = 0;
 	m_wol_operation_time = 0;
 	m_idle_time = time(NULL);
@@ -107,6 +111,7 @@ void RenderAf::setRegistered()
 void RenderAf::offline( JobContainer * jobs, uint32_t updateTaskState, MonitorContainer * monitoring, bool toZombie )
 {
 	setOffline();
+	RenderHeartbeats::SetOnline( m_id, false);
 	setBusy( false);
 	if( isWOLFalling())
 	{
@@ -140,29 +145,14 @@ void RenderAf::offline( JobContainer * jobs, uint32_t updateTaskState, MonitorCo
 	}
 }
 
-af::Msg * RenderAf::update( const af::RenderUpdate & i_up)
+void RenderAf::publishEvents()
 {
-	updateTime();
-
-	if( i_up.hasResources())
-		m_hres.copy( *i_up.getResources());
-
-	if( i_up.m_taskups.size())
-		for( int i = 0; i < i_up.m_taskups.size(); i++)
-			if( i_up.m_taskups[i]->getStatus() > af::TaskExec::UPWarning )
-				m_re.addTaskClose( af::MCTaskPos( *i_up.m_taskups[i]));
-
 	if( m_re.isEmpty())
-	{
-		// If there is no new events just return its id back.
-		return new af::Msg( af::Msg::TRenderId, getId());
-	}
-
-	af::Msg * msg = new af::Msg( af::Msg::TRenderEvents, &m_re);
-
-	m_re.clear();
+		return;
 
-	return msg;
+	// If previous events are not sent yet, new events are collected and published later.
+	if( RenderHeartbeats::Publish( m_id, m_re))
+		m_re.clear();
 }
 
 void RenderAf::online( RenderAf * render, JobContainer * i_jobs, MonitorContainer * monitoring)
@@ -184,8 +174,11 @@ void RenderAf::online( RenderAf * render, JobContainer * i_jobs, MonitorContaine
 	m_task_start_finish_time = 0;
 	m_address.copy( render->getAddress());
 	grabNetIFs( render->m_netIFs);
+	// Host properties and OS can be changed while render was offline,
+	// getFarmHost() drops their cached matches.
 	getFarmHost( &render->m_host);
 	setOnline();
+	RenderHeartbeats::SetOnline( m_id, true);
 	updateTime();
 	m_hres.copy( render->getHostRes());
 
@@ -318,6 +311,13 @@ void RenderAf::v_action( Action & i_action)
 			}
 			return;
 		}
+		else if( type == "reload_python")
+		{
+			if( false == isOnline()) return;
+			appendLog("Python modules reload by " + i_action.author);
+			m_re.m_instruction = "reload_python";
+			return;
+		}
 		else if( type == "eject_tasks")
 		{
 			if( false == isBusy()) return;
@@ -603,6 +603,7 @@ void RenderAf::removeTask( const af::TaskExec * i_exec)
 
 	// Remove exec pointer from events:
 	m_re.remTaskExec( i_exec);
+	RenderHeartbeats::RemoveTask( m_id, i_exec);
 
 	if( m_capacity_used < i_exec->getCapResult())
 	{
@@ -614,6 +615,10 @@ void RenderAf::removeTask( const af::TaskExec * i_exec)
 
 void RenderAf::v_refresh( time_t currentTime,  AfContainer * pointer, MonitorContainer * monitoring)
 {
+	// Get update time and resources, stored by render heartbeats:
+	if( isOnline())
+		RenderHeartbeats::Fetch( m_id, m_time_update, m_hres);
+
 	if( isLocked() ) return;
 
 	JobContainer * jobs = (JobContainer*)pointer;
@@ -832,6 +837,10 @@ bool RenderAf::getFarmHost( af::Host * newHost)
 	}
 	int servicesnum_old = m_services_num;
 
+	// Host properties will be changed, cached matches are not valid any more:
+	m_os_matches.clear();
+	m_properties_matches.clear();
+
 	// Clear services and services usage:
 	m_host.clearServices();
 	m_services_counts.clear();
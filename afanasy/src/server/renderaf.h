@@ -3,6 +3,7 @@
 #include "../include/afjob.h"
 
 #include "../libafanasy/msgclasses/mctaskup.h"
+#include "../libafanasy/regexp.h"
 #include "../libafanasy/render.h"
 #include "../libafanasy/renderevents.h"
 #include "../libafanasy/renderupdate.h"
@@ -62,6 +63,12 @@ public:
 /// Get host parameters from farm.
 	bool getFarmHost( af::Host * newHost = NULL);
 
+/// Cached matches of render name, OS and properties with nodes masks.
+/** OS and properties matches are cleared when host parameters may change. **/
+	inline af::RegExpCache & getNameMatches()       const { return m_name_matches;       }
+	inline af::RegExpCache & getOSMatches()         const { return m_os_matches;         }
+	inline af::RegExpCache & getPropertiesMatches() const { return m_properties_matches; }
+
 /// Deregister render, on SIGINT client recieving.
 	void deregister( JobContainer * jobs, MonitorContainer * monitoring );
 
@@ -75,8 +82,8 @@ public:
 
 	bool canRunService( const std::string & type) const; ///< Check whether block can run a service
 
-	// Update render and send instructions back:
-	af::Msg * update( const af::RenderUpdate & i_up);
+	/// Give events to render heartbeats, to send them on the next render update.
+	void publishEvents();
 
 	// Called directly from solve cycle if it was not solved.
 	void solvingFinished();
@@ -141,6 +148,10 @@ private:
 
 	af::RenderEvents m_re;
 
+	mutable af::RegExpCache m_name_matches;
+	mutable af::RegExpCache m_os_matches;
+	mutable af::RegExpCache m_properties_matches;
+
 private:
 	static RenderContainer * ms_renders;
 
@@ -120,6 +120,14 @@ bool RenderContainer::farmLoad( std::string & o_status, MonitorContainer * i_mon
 	return true;
 }
 
+void RenderContainer::publishEvents()
+{
+	RenderContainerIt rendersIt( this);
+	for( RenderAf *render = rendersIt.render(); render != NULL; rendersIt.next(), render = rendersIt.render())
+		if( render->isOnline())
+			render->publishEvents();
+}
+
 //##############################################################################
 
 RenderContainerIt::RenderContainerIt( RenderContainer* container, bool skipZombies):
@@ -19,6 +19,9 @@ public:
 	/// Reload farm settings from a config file.
 	/// Return true on success and a status (error) message.
 	bool farmLoad( std::string & o_status, MonitorContainer * i_monitors = NULL);
+
+	/// Give renders events to heartbeats, should be called at the end of a run cycle.
+	void publishEvents();
 };
 
 /// Renders iterator.
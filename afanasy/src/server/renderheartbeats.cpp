@@ -0,0 +1,404 @@
+#include "renderheartbeats.h"
+
+#include "../include/afanasy.h"
+
+#include "../libafanasy/common/dlScopeLocker.h"
+
+#include "../libafanasy/environment.h"
+#include "../libafanasy/host.h"
+#include "../libafanasy/msg.h"
+#include "../libafanasy/renderevents.h"
+#include "../libafanasy/renderupdate.h"
+#include "../libafanasy/taskexec.h"
+
+#include "runcycle.h"
+#include "socketsprocessing.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+struct RenderHeartbeats::Slot
+{
+	Slot(): online( false), time_update( 0), hres_new( false), events( NULL), waiting( NULL), wait_until( 0) {}
+	~Slot() { clearEvents(); }
+
+	void clearEvents()
+	{
+		if( NULL == events )
+			return;
+
+		// Events tasks are read from a message copy, so they are owned by slot:
+		for( int i = 0; i < events->m_tasks.size(); i++)
+			delete events->m_tasks[i];
+		delete events;
+		events = NULL;
+	}
+
+	bool online;
+
+	int64_t time_update;
+
+	bool hres_new;
+	af::HostRes hres;
+
+	af::RenderEvents * events;  ///< Published events copy, not sent yet.
+
+	SocketItem * waiting;  ///< Render request waiting for events.
+	int64_t wait_until;    ///< Waiting request is answered with no events at this time.
+};
+
+DlMutex RenderHeartbeats::ms_mutexes[RenderHeartbeats::ms_mutexes_num];
+
+RenderHeartbeats::Slot ** RenderHeartbeats::ms_slots = NULL;
+
+RenderHeartbeats::Stat RenderHeartbeats::ms_stats[RenderHeartbeats::ms_mutexes_num];
+
+DlMutex RenderHeartbeats::ms_waiting_mutex;
+std::set<int> RenderHeartbeats::ms_waiting;
+
+void RenderHeartbeats::Init()
+{
+	// Slots are allocated on render online, here only pointers are allocated.
+	ms_slots = new Slot*[AFRENDER::MAXCOUNT];
+	for( int i = 0; i < AFRENDER::MAXCOUNT; i++)
+		ms_slots[i] = NULL;
+}
+
+void RenderHeartbeats::Destroy()
+{
+	if( NULL == ms_slots )
+		return;
+
+	for( int i = 0; i < AFRENDER::MAXCOUNT; i++)
+		if( ms_slots[i] )
+			delete ms_slots[i];
+
+	delete [] ms_slots;
+	ms_slots = NULL;
+}
+
+DlMutex & RenderHeartbeats::getMutex( int i_id)
+{
+	return ms_mutexes[i_id % ms_mutexes_num];
+}
+
+RenderHeartbeats::Slot * RenderHeartbeats::getSlot( int i_id)
+{
+	if(( NULL == ms_slots ) || ( i_id <= 0 ) || ( i_id >= AFRENDER::MAXCOUNT ))
+		return NULL;
+
+	return ms_slots[i_id];
+}
+
+af::Msg * RenderHeartbeats::Update( const af::RenderUpdate & i_up, bool & o_online)
+{
+	o_online = false;
+
+	int id = i_up.getId();
+	af::RenderEvents * events = NULL;
+
+	if(( id > 0 ) && ( id < AFRENDER::MAXCOUNT ))
+	{
+		DlScopeLocker lock( &getMutex( id));
+
+		Stat & stat = ms_stats[id % ms_mutexes_num];
+		stat.updates++;
+
+		Slot * slot = getSlot( id);
+		if( slot && slot->online )
+		{
+			o_online = true;
+
+			slot->time_update = time( NULL);
+
+			if( i_up.hasResources())
+			{
+				slot->hres.copy( *i_up.getResources());
+				slot->hres_new = true;
+			}
+
+			// Take published events, slot does not own them any more:
+			events = slot->events;
+			slot->events = NULL;
+			if( events )
+				stat.events_sent++;
+		}
+		else
+			stat.updates_unknown++;
+	}
+
+	if( false == o_online )
+	{
+		// If there is not such online render, a zero id will be send.
+		// It is a signal for client to register again (may be server was restarted).
+		// The server may have not received any registration message from this render,
+		// but it is nevertheless running (server was restarted).
+		// Render should then register and reconnect its tasks.
+		return new af::Msg( af::Msg::TRenderId, 0);
+	}
+
+	// Finished tasks can be closed immediately,
+	// their updates will be processed by run thread.
+	for( int i = 0; i < i_up.m_taskups.size(); i++)
+		if( i_up.m_taskups[i]->getStatus() > af::TaskExec::UPWarning )
+		{
+			if( NULL == events )
+				events = new af::RenderEvents();
+			events->addTaskClose( af::MCTaskPos( *i_up.m_taskups[i]));
+		}
+
+	if(( NULL == events ) || events->isEmpty())
+	{
+		delete events;
+		// If there is no new events just return its id back.
+		return new af::Msg( af::Msg::TRenderId, id);
+	}
+
+	return eventsMsg( events);
+}
+
+af::Msg * RenderHeartbeats::eventsMsg( af::RenderEvents * i_events)
+{
+	af::Msg * msg = new af::Msg( af::Msg::TRenderEvents, i_events);
+
+	for( int i = 0; i < i_events->m_tasks.size(); i++)
+		delete i_events->m_tasks[i];
+	delete i_events;
+
+	return msg;
+}
+
+af::Msg * RenderHeartbeats::Wait( int i_id, SocketItem * i_si)
+{
+	if(( NULL == ms_slots ) || ( i_id <= 0 ) || ( i_id >= AFRENDER::MAXCOUNT ))
+		return new af::Msg( af::Msg::TRenderId, 0);
+
+	SocketItem * replaced = NULL;
+	{
+		DlScopeLocker lock( &getMutex( i_id));
+
+		Slot * slot = getSlot( i_id);
+		if(( NULL == slot ) || ( false == slot->online ))
+			return new af::Msg( af::Msg::TRenderId, 0);
+
+		Stat & stat = ms_stats[i_id % ms_mutexes_num];
+
+		if( slot->events )
+		{
+			af::RenderEvents * events = slot->events;
+			slot->events = NULL;
+			stat.events_sent++;
+			return eventsMsg( events);
+		}
+
+		// Render waits only once, previous request can be left from a lost connection.
+		replaced = slot->waiting;
+
+		slot->waiting = i_si;
+		slot->wait_until = RunCycle::NowMSec() + 1000 * af::Environment::getRenderHeartbeatSec();
+		stat.waits++;
+
+		DlScopeLocker wlock( &ms_waiting_mutex);
+		ms_waiting.insert( i_id);
+	}
+
+	if( replaced )
+		SocketsProcessing::AnswerWaiting( replaced, new af::Msg( af::Msg::TRenderId, i_id));
+
+	return NULL;
+}
+
+void RenderHeartbeats::CheckWaiting()
+{
+	std::vector<int> ids;
+	{
+		DlScopeLocker wlock( &ms_waiting_mutex);
+		ids.assign( ms_waiting.begin(), ms_waiting.end());
+	}
+
+	int64_t now = RunCycle::NowMSec();
+
+	for( int i = 0; i < ids.size(); i++)
+	{
+		SocketItem * waiting = NULL;
+		{
+			DlScopeLocker lock( &getMutex( ids[i]));
+
+			Slot * slot = getSlot( ids[i]);
+			if( slot && slot->waiting && ( now < slot->wait_until ))
+				continue;
+
+			if( slot && slot->waiting )
+			{
+				waiting = slot->waiting;
+				slot->waiting = NULL;
+			}
+
+			DlScopeLocker wlock( &ms_waiting_mutex);
+			ms_waiting.erase( ids[i]);
+		}
+
+		if( waiting )
+			SocketsProcessing::AnswerWaiting( waiting, new af::Msg( af::Msg::TRenderId, ids[i]));
+	}
+}
+
+void RenderHeartbeats::SetOnline( int i_id, bool i_online)
+{
+	if(( NULL == ms_slots ) || ( i_id <= 0 ) || ( i_id >= AFRENDER::MAXCOUNT ))
+	{
+		AF_ERR << "Invalid render id = " << i_id;
+		return;
+	}
+
+	DlScopeLocker lock( &getMutex( i_id));
+
+	Slot * slot = ms_slots[i_id];
+	if( NULL == slot )
+	{
+		if( false == i_online )
+			return;
+
+		slot = new Slot();
+		ms_slots[i_id] = slot;
+	}
+
+	// Render id can be used by another render, or render was reconnected,
+	// so previous updates and events are not valid any more.
+	slot->online = i_online;
+	slot->time_update = 0;
+	slot->hres_new = false;
+	slot->clearEvents();
+
+	// Zero id asks waiting render to register again.
+	if( slot->waiting )
+	{
+		SocketsProcessing::AnswerWaiting( slot->waiting, new af::Msg( af::Msg::TRenderId, 0));
+		slot->waiting = NULL;
+	}
+}
+
+bool RenderHeartbeats::Fetch( int i_id, int64_t & io_time_update, af::HostRes & o_hres)
+{
+	if( NULL == ms_slots )
+		return false;
+
+	DlScopeLocker lock( &getMutex( i_id));
+
+	Slot * slot = getSlot( i_id);
+	if(( NULL == slot ) || ( false == slot->online ))
+		return false;
+
+	if( slot->time_update > io_time_update )
+		io_time_update = slot->time_update;
+
+	if( false == slot->hres_new )
+		return false;
+
+	o_hres.copy( slot->hres);
+	slot->hres_new = false;
+
+	return true;
+}
+
+bool RenderHeartbeats::Publish( int i_id, af::RenderEvents & i_re)
+{
+	if( NULL == ms_slots )
+		return false;
+
+	{
+		DlScopeLocker lock( &getMutex( i_id));
+		Slot * slot = getSlot( i_id);
+		if(( NULL == slot ) || ( false == slot->online ) || slot->events )
+			return false;
+	}
+
+	// Events are copied through a message, as tasks executables belong to render and tasks,
+	// and can be changed or deleted by run thread while update thread sends events.
+	// It is done without lock, as only run thread publishes events.
+	af::Msg msg( af::Msg::TRenderEvents, &i_re);
+	af::Msg msg_read( msg.buffer(), msg.writeSize());
+	af::RenderEvents * events = new af::RenderEvents( &msg_read);
+
+	DlScopeLocker lock( &getMutex( i_id));
+
+	Slot * slot = getSlot( i_id);
+	if(( NULL == slot ) || ( false == slot->online ))
+	{
+		// Render became offline.
+		for( int i = 0; i < events->m_tasks.size(); i++)
+			delete events->m_tasks[i];
+		delete events;
+		return false;
+	}
+
+	Stat & stat = ms_stats[i_id % ms_mutexes_num];
+	stat.events_published++;
+
+	if( NULL == slot->waiting )
+	{
+		slot->events = events;
+		return true;
+	}
+
+	// Render waits for events, they are sent at once.
+	SocketItem * waiting = slot->waiting;
+	slot->waiting = NULL;
+	stat.events_pushed++;
+	stat.events_sent++;
+
+	lock.Unlock();
+
+	SocketsProcessing::AnswerWaiting( waiting, eventsMsg( events));
+
+	return true;
+}
+
+void RenderHeartbeats::RemoveTask( int i_id, const af::TaskExec * i_exec)
+{
+	if( NULL == ms_slots )
+		return;
+
+	DlScopeLocker lock( &getMutex( i_id));
+
+	Slot * slot = getSlot( i_id);
+	if(( NULL == slot ) || ( NULL == slot->events ))
+		return;
+
+	std::vector<af::TaskExec*> & tasks = slot->events->m_tasks;
+	for( std::vector<af::TaskExec*>::iterator it = tasks.begin(); it != tasks.end(); it++)
+	{
+		if( (*it)->equals( *i_exec))
+		{
+			delete *it;
+			tasks.erase( it);
+			return;
+		}
+	}
+}
+
+void RenderHeartbeats::jsonWrite( std::ostringstream & o_str)
+{
+	Stat sum;
+	for( int i = 0; i < ms_mutexes_num; i++)
+	{
+		DlScopeLocker lock( &ms_mutexes[i]);
+		sum.updates          += ms_stats[i].updates;
+		sum.updates_unknown  += ms_stats[i].updates_unknown;
+		sum.events_published += ms_stats[i].events_published;
+		sum.events_sent      += ms_stats[i].events_sent;
+		sum.waits            += ms_stats[i].waits;
+		sum.events_pushed    += ms_stats[i].events_pushed;
+	}
+
+	o_str << "\"render_heartbeats\":{";
+	o_str << "\"updates\":" << sum.updates;
+	o_str << ",\"updates_unknown\":" << sum.updates_unknown;
+	o_str << ",\"events_published\":" << sum.events_published;
+	o_str << ",\"events_sent\":" << sum.events_sent;
+	o_str << ",\"waits\":" << sum.waits;
+	o_str << ",\"events_pushed\":" << sum.events_pushed;
+	o_str << "}";
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <set>
+#include <sstream>
+
+#include "../libafanasy/common/dlMutex.h"
+
+#include "../libafanasy/name_af.h"
+
+namespace af
+{
+	class RenderEvents;
+	class RenderUpdate;
+}
+
+class SocketItem;
+
+/// Renders heartbeats (updates) processing without containers locks.
+/** Run thread holds all containers locks during a cycle,
+*** so render update can't wait for a render container lock to answer.
+*** Each render has a slot indexed by its id, slots are protected by sharded mutexes.
+*** Update thread stores resources and update time in a slot,
+*** and takes render events, published by run thread, from it.
+*** Run thread fetches stored resources on render refresh,
+*** and publishes render events at the end of a cycle.
+*** Render can wait for events, its request is answered as soon as events are published. **/
+class RenderHeartbeats
+{
+public:
+	static void Init();
+	static void Destroy();
+
+	/// Process render update, can be called from any thread.
+	/** Returns answer message: render events, render id if there are no events,
+	*** or zero id if there is no such online render (render should register again).
+	*** \c o_online is set to whether render is online. **/
+	static af::Msg * Update( const af::RenderUpdate & i_up, bool & o_online);
+
+	/// Wait for render events, can be called from any thread.
+	/** Returns answer message if events are already published or there is no such online render.
+	*** Otherwise returns NULL, socket item will be answered on events publish or heartbeat timeout. **/
+	static af::Msg * Wait( int i_id, SocketItem * i_si);
+
+	/// Answer waiting renders which heartbeat timeout is reached.
+	static void CheckWaiting();
+
+	/// Set render online or offline (render container should be locked).
+	/** Offline render slot events are discarded. **/
+	static void SetOnline( int i_id, bool i_online);
+
+	/// Get render update time and resources, if they was updated (run thread only).
+	static bool Fetch( int i_id, int64_t & io_time_update, af::HostRes & o_hres);
+
+	/// Store render events to send them on render update (run thread only).
+	/** If previous events are not sent yet, returns \c false and new events are kept by render. **/
+	static bool Publish( int i_id, af::RenderEvents & i_re);
+
+	/// Remove task from events not sent yet, as it was finished or stopped (run thread only).
+	static void RemoveTask( int i_id, const af::TaskExec * i_exec);
+
+	static void jsonWrite( std::ostringstream & o_str);
+
+private:
+	struct Slot;
+
+	/// Statistics, collected per mutex shard.
+	struct Stat
+	{
+		Stat(): updates( 0), updates_unknown( 0), events_published( 0), events_sent( 0), waits( 0), events_pushed( 0) {}
+		int64_t updates;
+		int64_t updates_unknown;
+		int64_t events_published;
+		int64_t events_sent;
+		int64_t waits;
+		int64_t events_pushed; ///< Events sent to waiting render just after publish.
+	};
+
+	static Slot * getSlot( int i_id);
+	static DlMutex & getMutex( int i_id);
+
+	/// Construct render events message, events are deleted.
+	static af::Msg * eventsMsg( af::RenderEvents * i_events);
+
+private:
+	static const int ms_mutexes_num = 64;
+	static DlMutex ms_mutexes[ms_mutexes_num];
+
+	static Slot ** ms_slots;
+
+	static Stat ms_stats[ms_mutexes_num];
+
+	/// Waiting renders ids, to check heartbeat timeout.
+	/** Slot mutex should be locked first. **/
+	static DlMutex ms_waiting_mutex;
+	static std::set<int> ms_waiting;
+};
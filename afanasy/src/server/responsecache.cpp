@@ -0,0 +1,120 @@
+#include "responsecache.h"
+
+#include "../libafanasy/common/dlScopeLocker.h"
+
+#include "../libafanasy/environment.h"
+#include "../libafanasy/msg.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+DlMutex ResponseCache::ms_mutex;
+std::map<std::string, ResponseCache::Entry> ResponseCache::ms_entries;
+
+int64_t ResponseCache::ms_hits = 0;
+int64_t ResponseCache::ms_misses = 0;
+int64_t ResponseCache::ms_not_modified = 0;
+
+af::Msg * ResponseCache::Get( const std::string & i_key, int64_t i_generation, int64_t i_client_generation, bool i_json)
+{
+	DlScopeLocker lock( &ms_mutex);
+
+	if( i_json && ( i_client_generation == i_generation ))
+	{
+		ms_not_modified++;
+		std::ostringstream str;
+		str << "{\"not_modified\":{\"generation\":" << i_generation << "}}";
+		return af::jsonMsg( str);
+	}
+
+	std::map<std::string, Entry>::const_iterator it = ms_entries.find( i_key);
+	if(( it == ms_entries.end()) || ( it->second.generation != i_generation ))
+	{
+		ms_misses++;
+		return NULL;
+	}
+
+	ms_hits++;
+
+	return entryMsg( it->second, i_json && ( i_client_generation != -1 ));
+}
+
+af::Msg * ResponseCache::Store( const std::string & i_key, int64_t i_generation, af::Msg * i_msg, int64_t i_client_generation)
+{
+	if(( NULL == i_msg ) || ( i_msg->type() < af::Msg::TDATA ) || ( i_msg->dataLen() <= 0 ))
+		return i_msg;
+
+	Entry entry;
+	entry.generation = i_generation;
+	entry.type = i_msg->type();
+	entry.data.assign( i_msg->data(), i_msg->dataLen());
+
+	bool add_generation = ( entry.type == af::Msg::TJSON ) && ( i_client_generation != -1 );
+	if( add_generation )
+	{
+		delete i_msg;
+		i_msg = entryMsg( entry, true);
+	}
+
+	DlScopeLocker lock( &ms_mutex);
+
+	// Keys are requests shapes, there are not many of them.
+	// Cache is just cleared if there are too many keys, for example too many users lists.
+	if(( ms_entries.size() >= af::Environment::getServerResponseCacheSize()) && ( ms_entries.find( i_key) == ms_entries.end()))
+		ms_entries.clear();
+
+	ms_entries[i_key].generation = entry.generation;
+	ms_entries[i_key].type = entry.type;
+	ms_entries[i_key].data.swap( entry.data);
+
+	return i_msg;
+}
+
+af::Msg * ResponseCache::entryMsg( const Entry & i_entry, bool i_add_generation)
+{
+	af::Msg * msg = new af::Msg();
+
+	if( false == i_add_generation )
+	{
+		msg->setData( i_entry.data.size(), i_entry.data.c_str(), i_entry.type);
+		return msg;
+	}
+
+	// Generation is added as the last root object member.
+	size_t pos = i_entry.data.rfind('}');
+	if( pos == std::string::npos )
+	{
+		msg->setData( i_entry.data.size(), i_entry.data.c_str(), i_entry.type);
+		return msg;
+	}
+
+	std::ostringstream str;
+	str.write( i_entry.data.c_str(), pos);
+	str << ",\"generation\":" << i_entry.generation;
+	str.write( i_entry.data.c_str() + pos, i_entry.data.size() - pos);
+
+	std::string data = str.str();
+	msg->setData( data.size(), data.c_str(), i_entry.type);
+
+	return msg;
+}
+
+void ResponseCache::jsonWrite( std::ostringstream & o_str)
+{
+	DlScopeLocker lock( &ms_mutex);
+
+	int64_t bytes = 0;
+	std::map<std::string, Entry>::const_iterator it = ms_entries.begin();
+	for( ; it != ms_entries.end(); it++)
+		bytes += it->second.data.size();
+
+	o_str << "\"response_cache\":{";
+	o_str << "\"entries\":" << ms_entries.size();
+	o_str << ",\"bytes\":" << bytes;
+	o_str << ",\"hits\":" << ms_hits;
+	o_str << ",\"misses\":" << ms_misses;
+	o_str << ",\"not_modified\":" << ms_not_modified;
+	o_str << "}";
+}
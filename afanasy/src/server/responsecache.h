@@ -0,0 +1,52 @@
+#pragma once
+
+#include <map>
+#include <sstream>
+
+#include "../libafanasy/common/dlMutex.h"
+
+#include "../libafanasy/environment.h"
+
+#include "../libafanasy/name_af.h"
+
+/// Cache of nodes lists responses.
+/** GUIs ask the same whole lists again and again, mostly when nothing is changed.
+*** Response is stored with a nodes change generation it was generated at,
+*** generation is changed by any node event (see MonitorContainer::getGeneration()).
+*** Cached response is returned while generation is the same.
+*** Client can send a generation of the list it has, to get "not modified" answer. **/
+class ResponseCache
+{
+public:
+	static inline bool IsEnabled() { return af::Environment::getServerResponseCacheSize() > 0; }
+
+	/// Get cached response message, can be called from any thread.
+	/** Returns "not modified" answer if client generation is the same (JSON only),
+	*** or response copy if it was generated at this generation, or NULL. **/
+	static af::Msg * Get( const std::string & i_key, int64_t i_generation, int64_t i_client_generation, bool i_json);
+
+	/// Store generated response, returns message to answer.
+	/** Response is copied, generation is added to JSON response if client asked it. **/
+	static af::Msg * Store( const std::string & i_key, int64_t i_generation, af::Msg * i_msg, int64_t i_client_generation);
+
+	static void jsonWrite( std::ostringstream & o_str);
+
+private:
+	struct Entry
+	{
+		int64_t generation;
+		int type;
+		std::string data;
+	};
+
+	/// Construct response message from cached entry.
+	static af::Msg * entryMsg( const Entry & i_entry, bool i_add_generation);
+
+private:
+	static DlMutex ms_mutex;
+	static std::map<std::string, Entry> ms_entries;
+
+	static int64_t ms_hits;
+	static int64_t ms_misses;
+	static int64_t ms_not_modified;
+};
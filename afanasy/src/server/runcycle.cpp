@@ -0,0 +1,181 @@
+#include "runcycle.h"
+
+#ifndef WINNT
+#include <sys/time.h>
+#include <time.h>
+#endif
+
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/environment.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+#ifdef WINNT
+HANDLE  RunCycle::ms_event = NULL;
+DlMutex RunCycle::ms_mutex;
+#else
+pthread_mutex_t RunCycle::ms_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t  RunCycle::ms_cond  = PTHREAD_COND_INITIALIZER;
+#endif
+
+bool    RunCycle::ms_woken = false;
+int64_t RunCycle::ms_wake_time = 0;
+int64_t RunCycle::ms_woken_time = 0;
+int64_t RunCycle::ms_cycle_start = 0;
+
+uint64_t RunCycle::ms_cycles = 0;
+uint64_t RunCycle::ms_cycles_woken = 0;
+int64_t  RunCycle::ms_latency_sum = 0;
+int64_t  RunCycle::ms_latency_max = 0;
+int64_t  RunCycle::ms_latency_last = 0;
+int64_t  RunCycle::ms_duration_sum = 0;
+int64_t  RunCycle::ms_duration_max = 0;
+int64_t  RunCycle::ms_duration_last = 0;
+
+void RunCycle::Init()
+{
+#ifdef WINNT
+	// Auto reset event, several wakes before wait result in a single cycle.
+	ms_event = CreateEvent( NULL, FALSE, FALSE, NULL);
+	if( ms_event == NULL )
+		AF_ERR << "CreateEvent failed.";
+#endif
+	ms_cycle_start = NowMSec();
+}
+
+void RunCycle::Destroy()
+{
+	// Wake run thread, it can be waiting on application exit:
+	Wake();
+}
+
+int64_t RunCycle::NowMSec()
+{
+#ifdef WINNT
+	return GetTickCount64();
+#elif defined(LINUX)
+	timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts);
+	return int64_t( ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+#else
+	timeval tv;
+	gettimeofday( &tv, NULL);
+	return int64_t( tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+#endif
+}
+
+void RunCycle::Wake()
+{
+#ifdef WINNT
+	DlScopeLocker lock( &ms_mutex);
+	if( false == ms_woken )
+	{
+		ms_woken = true;
+		ms_wake_time = NowMSec();
+		SetEvent( ms_event);
+	}
+#else
+	pthread_mutex_lock( &ms_mutex);
+	if( false == ms_woken )
+	{
+		ms_woken = true;
+		ms_wake_time = NowMSec();
+		pthread_cond_signal( &ms_cond);
+	}
+	pthread_mutex_unlock( &ms_mutex);
+#endif
+}
+
+bool RunCycle::Wait()
+{
+	int min_msec = af::Environment::getServerRunCycleMinMSec();
+	int max_msec = af::Environment::getServerRunCycleMaxMSec();
+	if( max_msec < min_msec )
+		max_msec = min_msec;
+
+	// Wait for an event, but not longer than maximum period since the cycle start:
+	int64_t wait_msec = ms_cycle_start + max_msec - NowMSec();
+	bool woken = false;
+
+#ifdef WINNT
+	if( wait_msec > 0 )
+		WaitForSingleObject( ms_event, DWORD( wait_msec));
+	{
+		DlScopeLocker lock( &ms_mutex);
+		woken = ms_woken;
+		ms_woken = false;
+		ms_woken_time = ms_wake_time;
+	}
+#else
+	pthread_mutex_lock( &ms_mutex);
+	if(( false == ms_woken ) && ( wait_msec > 0 ))
+	{
+		timeval tv;
+		gettimeofday( &tv, NULL);
+		int64_t deadline_usec = int64_t( tv.tv_sec) * 1000000 + tv.tv_usec + wait_msec * 1000;
+		timespec deadline;
+		deadline.tv_sec  = deadline_usec / 1000000;
+		deadline.tv_nsec = ( deadline_usec % 1000000 ) * 1000;
+
+		// Spurious wakeups are possible, so check the flag again:
+		while( false == ms_woken )
+			if( pthread_cond_timedwait( &ms_cond, &ms_mutex, &deadline) != 0 )
+				break;
+	}
+	woken = ms_woken;
+	ms_woken = false;
+	ms_woken_time = ms_wake_time;
+	pthread_mutex_unlock( &ms_mutex);
+#endif
+
+	// Keep minimum cycle period:
+	int64_t sleep_msec = ms_cycle_start + min_msec - NowMSec();
+	if( sleep_msec > 0 )
+		af::sleep_msec( int( sleep_msec));
+
+	return woken;
+}
+
+void RunCycle::CycleStarted( bool i_woken)
+{
+	ms_cycle_start = NowMSec();
+	ms_cycles++;
+
+	if( false == i_woken )
+		return;
+
+	ms_cycles_woken++;
+
+	ms_latency_last = ms_cycle_start - ms_woken_time;
+	ms_latency_sum += ms_latency_last;
+	if( ms_latency_last > ms_latency_max )
+		ms_latency_max = ms_latency_last;
+}
+
+void RunCycle::CycleFinished()
+{
+	ms_duration_last = NowMSec() - ms_cycle_start;
+	ms_duration_sum += ms_duration_last;
+	if( ms_duration_last > ms_duration_max )
+		ms_duration_max = ms_duration_last;
+}
+
+void RunCycle::jsonWrite( std::ostringstream & o_str)
+{
+	o_str << "\"run_cycle\":{";
+	o_str << "\"min_msec\":" << af::Environment::getServerRunCycleMinMSec();
+	o_str << ",\"max_msec\":" << af::Environment::getServerRunCycleMaxMSec();
+	o_str << ",\"cycles\":" << ms_cycles;
+	o_str << ",\"cycles_woken\":" << ms_cycles_woken;
+	o_str << ",\"cycles_timer\":" << ms_cycles - ms_cycles_woken;
+	o_str << ",\"latency_last_msec\":" << ms_latency_last;
+	o_str << ",\"latency_max_msec\":" << ms_latency_max;
+	o_str << ",\"latency_avg_msec\":" << ( ms_cycles_woken ? double( ms_latency_sum) / ms_cycles_woken : 0.0);
+	o_str << ",\"duration_last_msec\":" << ms_duration_last;
+	o_str << ",\"duration_max_msec\":" << ms_duration_max;
+	o_str << ",\"duration_avg_msec\":" << ( ms_cycles ? double( ms_duration_sum) / ms_cycles : 0.0);
+	o_str << "}";
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#ifdef WINNT
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <stdint.h>
+#include <sstream>
+
+#include "../libafanasy/common/dlMutex.h"
+
+/// Run cycle thread scheduler.
+/** Run thread sleeps until something to process arrives
+*** (render tasks updates, messages for run thread, new jobs and renders),
+*** or maximum cycle period passes to process timers.
+*** Cycles can not follow more often than minimum cycle period.
+*** Class also collects cycles latency and duration statistics. **/
+class RunCycle
+{
+public:
+	static void Init();
+	static void Destroy();
+
+	/// Wake run thread up, can be called from any thread.
+	static void Wake();
+
+	/// Wait for the next cycle, should be called from run thread only.
+	/** Returns \c true if cycle was woken by an event, \c false on timeout. **/
+	static bool Wait();
+
+	/// Mark cycle start and finish to collect statistics (run thread only).
+	static void CycleStarted( bool i_woken);
+	static void CycleFinished();
+
+	static void jsonWrite( std::ostringstream & o_str);
+
+	/// Monotonic clock milliseconds, can be used to measure any server durations.
+	static int64_t NowMSec();
+
+private:
+#ifdef WINNT
+	static HANDLE  ms_event;
+	static DlMutex ms_mutex;
+#else
+	static pthread_mutex_t ms_mutex;
+	static pthread_cond_t  ms_cond;
+#endif
+
+	static bool    ms_woken;
+	static int64_t ms_wake_time;   ///< Time of the first wake request since the last cycle.
+	static int64_t ms_woken_time;  ///< Wake time taken under mutex by the run thread for the cycle statistics.
+
+	static int64_t ms_cycle_start;
+
+	/// Statistics:
+	static uint64_t ms_cycles;
+	static uint64_t ms_cycles_woken;
+	static int64_t  ms_latency_sum;
+	static int64_t  ms_latency_max;
+	static int64_t  ms_latency_last;
+	static int64_t  ms_duration_sum;
+	static int64_t  ms_duration_max;
+	static int64_t  ms_duration_last;
+};
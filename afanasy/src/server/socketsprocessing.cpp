@@ -30,7 +30,10 @@
 #include "../libafanasy/environment.h"
 #include "../libafanasy/msg.h"
 
+#include "monitorcontainer.h"
 #include "profiler.h"
+#include "renderheartbeats.h"
+#include "runcycle.h"
 
 #ifdef WINNT
 #define MSG_DONTWAIT 0
@@ -40,6 +43,7 @@
 
 #ifdef LINUX
 #include <sys/epoll.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #endif
 
@@ -67,12 +71,15 @@ SocketItem::SocketItem( int i_sfd, sockaddr_storage * i_sas):
 	m_header_reading_finished( false),
 	m_reading_finished( false),
 
-	m_write_buffer( NULL),
+	m_write_header( NULL),
+	m_write_header_len(0),
 	m_write_size(0),
 	m_bytes_written(0),
 	#endif // LINUX
 
-	m_zombie(false)
+	m_zombie(false),
+	m_keep_alive(false),
+	m_keep_alive_time(0)
 {
 	m_msg_req = new af::Msg( m_sas);
 
@@ -110,8 +117,8 @@ SocketItem::~SocketItem()
 	if( m_msg_ans ) delete m_msg_ans;
 
 	#ifdef LINUX
-	if( m_write_buffer )
-		delete [] m_write_buffer;
+	if( m_write_header )
+		delete [] m_write_header;
 	#endif // LINUX
 
 	// Delete profiler. 
@@ -157,13 +164,12 @@ void SocketItem::generateInfoStream( std::ostringstream & o_str, bool i_full) co
 	if( m_msg_ans ) o_str << " ANS: " << m_msg_ans;
 }
 
-bool SocketItem::processMsg( ThreadArgs * i_args)
+SocketItem::ProcessResult SocketItem::processMsg( ThreadArgs * i_args)
 {
-	// Return TRUE means ready to answer.
 	if( m_state != SSProcessing )
 	{
 		AF_ERR << "A try to process invalid socket item state: " << this;
-		return true;
+		return PRAnswer;
 	}
 
 	m_profiler->processingStarted();
@@ -172,7 +178,35 @@ bool SocketItem::processMsg( ThreadArgs * i_args)
 	{
 		m_msg_ans = httpGet( m_msg_req);
 		m_profiler->processingFinished();
-		return true;
+		return PRAnswer;
+	}
+
+	if( m_msg_req->type() == af::Msg::TKeepAlive )
+	{
+		// Persistent connections are supported by non-blocking IO only,
+		// blocking IO needs a thread per connection.
+		int timeout = 0;
+		#ifdef LINUX
+		if( SocketsProcessing::UsingEpoll())
+			timeout = af::Environment::getServerConnectionKeepAliveSec();
+		#endif
+		m_keep_alive = timeout > 0;
+		m_msg_ans = new af::Msg( af::Msg::TKeepAlive, timeout);
+		m_profiler->processingFinished();
+		return PRAnswer;
+	}
+
+	if( m_msg_req->type() == af::Msg::TRenderEventsWait )
+	{
+		// If there are no events, item is stored to be answered later.
+		// It can be answered by another thread at once, so it should not be touched here after.
+		af::Msg * msg_ans = RenderHeartbeats::Wait( m_msg_req->int32(), this);
+		if( NULL == msg_ans )
+			return PRWait;
+
+		m_msg_ans = msg_ans;
+		m_profiler->processingFinished();
+		return PRAnswer;
 	}
 /*
 	// Check message IP trust mask:
@@ -194,13 +228,23 @@ bool SocketItem::processMsg( ThreadArgs * i_args)
 		// No answer means that message was not processed.
 		// And it will be pushed to run thread queue.
 		// So no answer is ready.
-		return false;
+		return PRRun;
+	}
+
+	if( m_msg_ans->type() == af::Msg::TMonitorEventsWait )
+	{
+		// Monitor has no events and asked to wait for them.
+		// Item will be processed again on events dispatch, or answered on wait timeout.
+		int id = m_msg_ans->int32();
+		delete m_msg_ans;
+		m_msg_ans = NULL;
+		i_args->monitors->waitEvents( id, this, m_msg_req->type() != af::Msg::TMonitorEventsWait);
+		return PRWait;
 	}
 
 	m_profiler->processingFinished();
 
-	// Return TRUE means ready to answer.
-	return true;
+	return PRAnswer;
 }
 
 void SocketItem::processRun( ThreadArgs * i_args)
@@ -212,12 +256,20 @@ void SocketItem::processRun( ThreadArgs * i_args)
 	m_profiler->processingFinished();
 }
 
-void SocketItem::writeMsg()
+void SocketItem::processWaiting( af::Msg * i_msg_ans)
 {
+	m_msg_ans = i_msg_ans;
+
+	m_profiler->processingFinished();
+}
+
+bool SocketItem::writeMsg()
+{
+	// Return TRUE means that the next message of a persistent connection is read and ready to process.
 	if( m_state == SSWriting )
 	{
 		AF_ERR << "SocketItem::writeMsg: Repeated call on: " << this;
-		return;
+		return false;
 	}
 
 	m_state = SSWriting;
@@ -227,7 +279,7 @@ void SocketItem::writeMsg()
 		// No answer exist means no answer needed.
 		// For example on browser close (monitor deregister) it will not wait any answer
 		waitClose();
-		return;
+		return false;
 	}
 
 	// Set HTTP message type.
@@ -239,10 +291,7 @@ void SocketItem::writeMsg()
 
 	#ifdef LINUX
 	if( SocketsProcessing::UsingEpoll())
-	{
-		writeData();
-		return;
-	}
+		return writeData();
 	#endif
 
 	// Write response message back to client socket
@@ -253,10 +302,11 @@ void SocketItem::writeMsg()
 		m_msg_req->stdOutData();
 		m_msg_ans->stdOutData();
 		closeSocket();
-		return;
+		return false;
 	}
 
 	waitClose();
+	return false;
 }
 
 #ifdef LINUX
@@ -268,6 +318,12 @@ bool SocketItem::processIO( int i_events)
 		return false;
 	}
 
+	// Processing item belongs to processing or run thread, or it waits for an answer.
+	// It will be closed on answer writing error.
+	// Persistent connection socket can become writable again while the next message is processing.
+	if( m_state == SSProcessing )
+		return false;
+
 	if( i_events & EPOLLERR )
 	{
 		if( m_state != SSWaiting )
@@ -291,8 +347,7 @@ bool SocketItem::processIO( int i_events)
 	case SSReading:
 		return readData();
 	case SSWriting:
-		writeData();
-		break;
+		return writeData();
 	case SSWaiting:
 		break;
 	case SSClosed:
@@ -300,9 +355,6 @@ bool SocketItem::processIO( int i_events)
 		// and that a previous one made the fd close
 		AF_WARN << "EPOLL event on a closed socket item: " << this;
 		break;
-	case SSProcessing:
-		AF_WARN << "EPOLL event on processing socket item: " << this;
-		break;
 	default:
 		AF_ERR << "EPOLL event on unknown socket item state: " << this;
 	}
@@ -323,6 +375,12 @@ bool SocketItem::readData()
 	if( false == m_header_reading_finished )
 	{
 		int size = read( m_sfd, m_msg_req->buffer() + m_bytes_read, af::Msg::SizeBuffer - m_bytes_read);
+		if(( size == 0 ) && m_keep_alive && ( m_bytes_read == 0 ))
+		{
+			// Client closed persistent connection between messages.
+			closeSocket();
+			return false;
+		}
 		if( size < 1 )
 		{
 			if( errno != EAGAIN )
@@ -402,45 +460,46 @@ bool SocketItem::readData()
 	return false;
 }
 
-void SocketItem::writeData()
+bool SocketItem::writeData()
 {
 	if( NULL == m_msg_ans )
 	{
 		AF_ERR << "SocketItem::writeData(): The answer is NULL: " << this;
-		return;
+		return false;
 	}
 
-	if( NULL ==  m_write_buffer )
+	if( 0 == m_write_size )
 	{
 		// This is the first writing call.
-		// We should allocate and fill in write buffer.
-		int header_len = 0;
-		char * header_buf = af::msgMakeWriteHeader( m_msg_ans );
-		if( header_buf )
-			header_len = strlen( header_buf);
-
-		m_write_size = header_len + m_msg_ans->writeSize() - m_msg_ans->getHeaderOffset();
-		m_write_buffer = new char[m_write_size];
-		if( header_buf )
-		{
-			memcpy( m_write_buffer, header_buf, header_len);
-			delete [] header_buf;
-		}
-		memcpy( m_write_buffer + header_len, m_msg_ans->buffer() + m_msg_ans->getHeaderOffset(), m_msg_ans->writeSize() - m_msg_ans->getHeaderOffset());
+		// Header and message buffer are written together by writev,
+		// answer data is not copied to a write buffer.
+		m_write_header = af::msgMakeWriteHeader( m_msg_ans );
+		if( m_write_header )
+			m_write_header_len = strlen( m_write_header);
+
+		m_write_size = m_write_header_len + m_msg_ans->writeSize() - m_msg_ans->getHeaderOffset();
 	}
 
 	if( m_bytes_written >= m_write_size )
 	{
 		AF_WARN << "SocketItem::writeData(): m_bytes_written >= m_write_size ( " << m_bytes_written << " >= " << m_write_size << " ): " << this;
-		return;
+		return false;
 	}
 
-	int bytes;
-	#ifdef WINNT
-	bytes = send( m_sfd, m_write_buffer + m_bytes_written, m_write_size - m_bytes_written, 0);
-	#else
-	bytes = write(m_sfd, m_write_buffer + m_bytes_written, m_write_size - m_bytes_written);
-	#endif
+	struct iovec iov[2];
+	int iov_count = 0;
+	if( m_bytes_written < m_write_header_len )
+	{
+		iov[iov_count].iov_base = m_write_header + m_bytes_written;
+		iov[iov_count].iov_len  = m_write_header_len - m_bytes_written;
+		iov_count++;
+	}
+	int data_written = m_bytes_written > m_write_header_len ? m_bytes_written - m_write_header_len : 0;
+	iov[iov_count].iov_base = m_msg_ans->buffer() + m_msg_ans->getHeaderOffset() + data_written;
+	iov[iov_count].iov_len  = m_write_size - m_write_header_len - data_written;
+	iov_count++;
+
+	int bytes = writev( m_sfd, iov, iov_count);
 
 	if( bytes >= 0 )
 	{
@@ -448,23 +507,55 @@ void SocketItem::writeData()
 
 		if( m_bytes_written >= m_write_size )
 		{
+			if( m_keep_alive )
+				return keepAlive();
+
 			waitClose();
 		}
 
-		return;
+		return false;
 	}
 
 	switch( errno )
 	{
 	case EAGAIN:
-		return;
+		return false;
 	default:
 		AF_ERR << "Socket writing error: " << af::sockAddrToStr( m_sas) << ": " << this;
 	}
 
 	closeSocket();
 
-	return;
+	return false;
+}
+
+bool SocketItem::keepAlive()
+{
+	// Collect previous message profile, as on socket close.
+	Profiler::Collect( m_profiler);
+	m_profiler = new Profiler();
+
+	delete m_msg_req;
+	m_msg_req = new af::Msg( m_sas);
+
+	delete m_msg_ans;
+	m_msg_ans = NULL;
+
+	delete [] m_write_header;
+	m_write_header = NULL;
+	m_write_header_len = 0;
+	m_write_size = 0;
+	m_bytes_written = 0;
+
+	m_bytes_read = 0;
+	m_header_reading_finished = false;
+	m_reading_finished = false;
+
+	m_state = SSReading;
+	m_keep_alive_time = time( NULL);
+
+	// Connection is edge triggered, the next message can be already received.
+	return readData();
 }
 #endif // LINUX
 
@@ -489,8 +580,8 @@ void SocketItem::waitClose()
 	#ifdef WINNT
 	// Set socket non-blocking on Windows:
 	u_long iMode = 1;
-	int iResult = ioctlsocket( m_sfd, FIONBIO, &iMode);
-	if (iResult != NO_ERROR)
+	int iResult = ioctlsocket( m_sfd, FIONBIO, &iMode);
+	if (iResult != NO_ERROR)
 		AF_ERR << "ioctlsocket failed with error: " << iResult;
 	#endif
 }
@@ -522,6 +613,16 @@ void SocketItem::checkClosed()
 	}
 }
 
+void SocketItem::checkKeepAlive()
+{
+	// Only idle connection, that does not read any message, is closed.
+	if(( false == m_keep_alive ) || ( SSReading != m_state ) || m_bytes_read )
+		return;
+
+	if( time( NULL) - m_keep_alive_time > af::Environment::getServerConnectionKeepAliveSec())
+		closeSocket();
+}
+
 void SocketItem::closeSocket()
 {
 	if( SSClosed == m_state )
@@ -755,10 +856,30 @@ void SocketsProcessing::doProc()
 	if( NULL == si )
 		return;
 
-	if( si->processMsg( m_threadargs))
+	switch( si->processMsg( m_threadargs))
+	{
+	case SocketItem::PRAnswer:
 		m_queue_io->pushSI( si);
-	else
+		break;
+	case SocketItem::PRRun:
 		m_queue_run->pushSI( si);
+		RunCycle::Wake();
+		break;
+	case SocketItem::PRWait:
+		// Item will be pushed by AnswerWaiting().
+		break;
+	}
+}
+
+void SocketsProcessing::AnswerWaiting( SocketItem * i_si, af::Msg * i_msg_ans)
+{
+	i_si->processWaiting( i_msg_ans);
+	ms_this->m_queue_io->pushSI( i_si);
+}
+
+void SocketsProcessing::ProcessAgain( SocketItem * i_si)
+{
+	ms_this->m_queue_proc->pushSI( i_si);
 }
 
 void SocketsProcessing::processRun()
@@ -842,7 +963,8 @@ void SocketsProcessing::doEpoll()
 		{
 			if( false == si->isEpollAdded())
 				epollAddSocket( si);
-			si->writeMsg();
+			if( si->writeMsg())
+				m_queue_proc->pushSI( si);
 			break;
 		}
 		default:
@@ -891,6 +1013,12 @@ void SocketsProcessing::doEpoll()
 			(*it)->checkClosed();
 		}
 
+		// Close idle persistent connections:
+		if((*it)->getState() == SocketItem::SSReading )
+		{
+			(*it)->checkKeepAlive();
+		}
+
 		// Free zombies:
 		if((*it)->isZombie())
 		{
@@ -23,6 +23,12 @@ public:
 		SSClosed
 	};
 
+	enum ProcessResult {
+		PRAnswer, // Answer is ready
+		PRRun,    // Message should be processed by run thread
+		PRWait    // Item waits for an answer, it will be pushed to write by another thread
+	};
+
 	void generateInfoStream( std::ostringstream & o_str, bool i_full = false) const;
 	inline const std::string generateInfoString( bool i_full = false) const { std::ostringstream str; generateInfoStream( str, i_full); return str.str();}
 	friend inline std::ostream & operator<<( std::ostream & o_str, const SocketItem * i_si) { o_str << i_si->generateInfoString(); return o_str; }
@@ -32,10 +38,12 @@ public:
 	inline bool isZombie() const { return m_zombie;}
 
 	bool readMsg();
-	bool processMsg( ThreadArgs * i_args);
+	ProcessResult processMsg( ThreadArgs * i_args);
 	void processRun( ThreadArgs * i_args);
-	void writeMsg();
+	void processWaiting( af::Msg * i_msg_ans);
+	bool writeMsg();
 	void checkClosed();
+	void checkKeepAlive();
 
 	#ifdef LINUX
 	// For non-blocking IO:
@@ -48,6 +56,9 @@ private:
 	void waitClose();
 	void closeSocket();
 
+	/// Prepare persistent connection to read the next message.
+	bool keepAlive();
+
 private:
 	int m_state;
 
@@ -62,6 +73,9 @@ private:
 	time_t m_wait_time;
 	bool m_zombie;
 
+	bool   m_keep_alive;      ///< Client asked to keep connection for next messages.
+	time_t m_keep_alive_time; ///< Last message time, to close idle connection.
+
 	#ifdef LINUX
 	// For non-blocking IO:
 	bool readData();
@@ -70,8 +84,9 @@ private:
 	bool m_reading_finished;
 	bool m_epoll_added;
 
-	void   writeData();
-	char * m_write_buffer;
+	bool   writeData();
+	char * m_write_header;     ///< HTTP header, written before answer message buffer.
+	int    m_write_header_len;
 	int    m_write_size;
 	int    m_bytes_written;
 	#endif
@@ -101,6 +116,12 @@ public:
 	static void EpollDel( int i_sfd);
 	#endif
 
+	/// Push waiting item to write an answer, can be called from any thread.
+	static void AnswerWaiting( SocketItem * i_si, af::Msg * i_msg_ans);
+
+	/// Push waiting item to process its request again, can be called from any thread.
+	static void ProcessAgain( SocketItem * i_si);
+
 private:
 	static void ThreadFuncProc( void * i_args);
 	void doProc();
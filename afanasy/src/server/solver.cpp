@@ -4,6 +4,7 @@
 #include "../libafanasy/environment.h"
 
 #include "afnodesolve.h"
+#include "runcycle.h"
 #include "jobcontainer.h"
 #include "rendercontainer.h"
 #include "usercontainer.h"
@@ -20,7 +21,10 @@ UserContainer    * Solver::ms_usercontainer   = NULL;
 MonitorContainer * Solver::ms_monitorcontaier = NULL;
 
 int Solver::ms_solve_cycles_limit = 100000;
-int Solver::ms_awaken_renders;
+int Solver::ms_awaken_renders = 0;
+int Solver::ms_tasks_solved = 0;
+int64_t Solver::ms_limits_period = 0;
+bool Solver::ms_renders_sorted = false;
 
 Solver::Solver(
 		JobContainer     * i_jobcontainer,
@@ -87,6 +91,17 @@ struct GreaterPriorityThenOlderCreation : public std::binary_function<AfNodeSolv
 	}
 };
 
+// Insert an item before the first item it is greater than,
+// so list stays sorted the same way as std::list::sort does with the same functor.
+template <class T, class Compare>
+static void InsertSorted( std::list<T> & o_list, T i_item, Compare i_greater)
+{
+	typename std::list<T>::iterator it = o_list.begin();
+	while(( it != o_list.end()) && ( false == i_greater( i_item, *it)))
+		it++;
+	o_list.insert( it, i_item);
+}
+
 void Solver::solve()
 {
 	//
@@ -109,81 +124,218 @@ void Solver::solve()
 
 	int solve_cycle = 0;
 	int tasks_solved = 0;
-	ms_awaken_renders = 0;
 
-	// Run solve cycle:
-	while( solve_list.size())
+	// Solve cycles are event driven and their rate varies,
+	// so tasks speed and wake limits are counted per second:
+	int64_t now = RunCycle::NowMSec();
+	if( now - ms_limits_period >= 1000 )
+	{
+		ms_limits_period = now;
+		ms_awaken_renders = 0;
+		ms_tasks_solved = 0;
+	}
+	if( tasksSpeedReached())
+		solve_list.clear();
+
+	ms_renders_sorted = af::Environment::getSolvingIncremental();
+
+	if( ms_renders_sorted )
+	{
+		solveIncremental( solve_list, solve_cycle, tasks_solved);
+	}
+	else
+	{
+		while( solve_list.size())
+		{
+			// Increment cycle and check limit:
+			solve_cycle++;
+			if( solve_cycle > ms_solve_cycles_limit )
+			{
+				// This should not happen.
+				// Most probably it is a bug in solving code.
+				AF_WARN << "Solve reached cycles limit: " << ms_solve_cycles_limit;
+				break;
+			}
+
+			// Get ready renders:
+			std::list<RenderAf*> renders_list;
+			RenderContainerIt rendersIt( ms_rendercontainer);
+			for( RenderAf * render = rendersIt.render(); render != NULL; rendersIt.next(), render = rendersIt.render())
+			{
+				// Check that render is ready to run a task:
+				if( isRenderSolvable( render))
+					renders_list.push_back( render);
+			}
+
+			// Function exits on each solve success (just 1 task solved),
+			// removes nodes that was not solved from list.
+			RenderAf * render = SolveList( solve_list, renders_list, af::Work::SolveByPriority);
+			if( render )
+				renderSolved( render, tasks_solved);
+
+			// Check tasks solving speed limit:
+			if( tasksSpeedReached())
+				break;
+		}
+	}
+
+	AF_DEBUG << "Solved " << tasks_solved << " tasks within " << solve_cycle << " cycles.";
+
+	// This needed to set render not busy if has no tasks.
+	// This prevents not to reset render busy state if it runs tasks one by one.
+	RenderContainerIt rendersIt( ms_rendercontainer);
+	for( RenderAf * render = rendersIt.render(); render != NULL; rendersIt.next(), render = rendersIt.render())
+		render->solvingFinished();
+
+	// Free users jobs lists sorted for this solve.
+	UserContainerIt usersIt( ms_usercontainer);
+	for( UserAf * user = usersIt.user(); user != NULL; usersIt.next(), user = usersIt.user())
+		user->solvingFinished();
+}
+
+void Solver::solveIncremental( std::list<AfNodeSolve*> & io_list, int & io_solve_cycle, int & io_tasks_solved)
+{
+	// Nodes and renders are sorted only once here.
+	// After each solved task only the solved node and the render that got a task
+	// change their need and readiness, so only they are repositioned.
+	// All other nodes and renders keep their order until the next solve.
+	// Users sort their jobs lists the same way (see UserAf::v_solve).
+	// Renders are still filtered for each solved node by its hosts masks and limits,
+	// as they depend on the node and change with each solved task.
+
+	std::list<RenderAf*> renders_list;
+	RenderContainerIt rendersIt( ms_rendercontainer);
+	for( RenderAf * render = rendersIt.render(); render != NULL; rendersIt.next(), render = rendersIt.render())
+	{
+		if( isRenderSolvable( render))
+			renders_list.push_back( render);
+	}
+	renders_list.sort( MostReadyRender());
+
+	for( std::list<AfNodeSolve*>::iterator it = io_list.begin(); it != io_list.end(); )
+	{
+		if((*it)->v_canRun())
+			it++;
+		else
+			it = io_list.erase( it);
+	}
+	if( af::Environment::getSolvingSimpler())
+		io_list.sort( GreaterPriorityThenOlderCreation());
+	else
+		io_list.sort( GreaterNeed());
+
+	while( io_list.size())
 	{
 		// Increment cycle and check limit:
-		solve_cycle++;
-		if( solve_cycle > ms_solve_cycles_limit )
+		io_solve_cycle++;
+		if( io_solve_cycle > ms_solve_cycles_limit )
 		{
-			// This should not happen.
-			// Most probably it is a bug in solving code.
 			AF_WARN << "Solve reached cycles limit: " << ms_solve_cycles_limit;
 			break;
 		}
 
-		// Get ready renders:
-		std::list<RenderAf*> renders_list;
-		RenderContainerIt rendersIt( ms_rendercontainer);
-		for( RenderAf * render = rendersIt.render(); render != NULL; rendersIt.next(), render = rendersIt.render())
+		// Find the first node that is able to solve,
+		// nodes that can't run or was not solved are removed.
+		RenderAf * render = NULL;
+		std::list<AfNodeSolve*>::iterator it = io_list.begin();
+		while( it != io_list.end())
 		{
-			// Check that render is ready to run a task:
-			if( false == render->isReady())
+			// Node can became not able to run after some other node solved,
+			// for example user reached its maximum running tasks.
+			if( false == (*it)->v_canRun())
 			{
-				// Render is not ready, but may be we can wake it up
-				if(( false == render->isWOLWakeAble()) || ( ms_awaken_renders >= af::Environment::getSolvingWakePerCycle() ))
-				{
-					continue; ///< - We can't
-				}
+				it = io_list.erase( it);
+				continue;
 			}
 
-			renders_list.push_back( render);
+			render = SolveNode( *it, renders_list);
+			if( render )
+				break;
+
+			it = io_list.erase( it);
 		}
 
-		// Function exits on each solve success (just 1 task solved),
-		// removes nodes that was not solved from list.
-		RenderAf * render = SolveList( solve_list, renders_list, af::Work::SolveByPriority);
-		if( render )
+		if( NULL == render )
+			break;
+
+		// Reposition solved node, as its need changed:
+		AfNodeSolve * node = *it;
+		io_list.erase( it);
+		if( node->v_canRun())
 		{
-			// Check Wake-On-LAN:
-			if( render->isWOLWakeAble())
+			if( af::Environment::getSolvingSimpler())
+				InsertSorted( io_list, node, GreaterPriorityThenOlderCreation());
+			else
+				InsertSorted( io_list, node, GreaterNeed());
+		}
+
+		// Reposition render, as its tasks and capacity changed:
+		renders_list.remove( render);
+		bool woken = renderSolved( render, io_tasks_solved);
+		if( isRenderSolvable( render))
+			InsertSorted( renders_list, render, MostReadyRender());
+
+		// Wake limit reached, remove all other not ready renders:
+		if( woken && ( ms_awaken_renders >= af::Environment::getSolvingWakePerCycle()))
+		{
+			for( std::list<RenderAf*>::iterator rIt = renders_list.begin(); rIt != renders_list.end(); )
 			{
-				AF_DEBUG << "Solving waking up render '" << render->node()->getName() << "'.";
-				render->wolWake( ms_monitorcontaier, std::string("Automatic waking by a job."));
-				ms_awaken_renders++;
+				if( isRenderSolvable( *rIt))
+					rIt++;
+				else
+					rIt = renders_list.erase( rIt);
 			}
-			else
-				tasks_solved++;
 		}
 
 		// Check tasks solving speed limit:
-		if(( af::Environment::getSolvingTasksSpeed() >= 0 ) &&
-			( tasks_solved >= af::Environment::getSolvingTasksSpeed()))
-		{
+		if( tasksSpeedReached())
 			break;
-		}
 	}
+}
 
-	AF_DEBUG << "Solved " << tasks_solved << " tasks within " << solve_cycle << " cycles.";
+bool Solver::isRenderSolvable( RenderAf * i_render)
+{
+	if( i_render->isReady())
+		return true;
 
-	// This needed to set render not busy if has no tasks.
-	// This prevents not to reset render busy state if it runs tasks one by one.
-	RenderContainerIt rendersIt( ms_rendercontainer);
-	for( RenderAf * render = rendersIt.render(); render != NULL; rendersIt.next(), render = rendersIt.render())
-		render->solvingFinished();
+	// Render is not ready, but may be we can wake it up
+	if(( false == i_render->isWOLWakeAble()) || ( ms_awaken_renders >= af::Environment::getSolvingWakePerCycle() ))
+		return false; ///< - We can't
+
+	return true;
 }
 
-RenderAf * Solver::SolveList( std::list<AfNodeSolve*> & i_list, std::list<RenderAf*> & i_renders, af::Work::SolvingMethod i_method)
+bool Solver::renderSolved( RenderAf * i_render, int & io_tasks_solved)
+{
+	// Check Wake-On-LAN:
+	if( i_render->isWOLWakeAble())
+	{
+		AF_DEBUG << "Solving waking up render '" << i_render->node()->getName() << "'.";
+		i_render->wolWake( ms_monitorcontaier, std::string("Automatic waking by a job."));
+		ms_awaken_renders++;
+		return true;
+	}
+
+	io_tasks_solved++;
+	ms_tasks_solved++;
+	return false;
+}
+
+bool Solver::tasksSpeedReached()
+{
+	return ( af::Environment::getSolvingTasksSpeed() >= 0 ) &&
+		( ms_tasks_solved >= af::Environment::getSolvingTasksSpeed());
+}
+
+void Solver::SortList( std::list<AfNodeSolve*> & io_list, af::Work::SolvingMethod i_method)
 {
 	// Remove nodes that need no solving at all (done, offline, ...)
-	for( std::list<AfNodeSolve*>::iterator it = i_list.begin(); it != i_list.end(); )
+	for( std::list<AfNodeSolve*>::iterator it = io_list.begin(); it != io_list.end(); )
 	{
 		if((*it)->v_canRun())
 			it++;
 		else
-			it = i_list.erase( it);
+			it = io_list.erase( it);
 	}
 
 	// Sort list if needed.
@@ -191,29 +343,59 @@ RenderAf * Solver::SolveList( std::list<AfNodeSolve*> & i_list, std::list<Render
 	if( i_method != af::Work::SolveByOrder )
 	{
 		if( af::Environment::getSolvingSimpler())
-			i_list.sort( GreaterPriorityThenOlderCreation());
+			io_list.sort( GreaterPriorityThenOlderCreation());
 		else
-			i_list.sort( GreaterNeed());
+			io_list.sort( GreaterNeed());
 	}
+}
 
-	// Iterate solving nodes list:
-	for( std::list<AfNodeSolve*>::iterator it = i_list.begin(); it != i_list.end(); )
+RenderAf * Solver::SolveSortedList( std::list<AfNodeSolve*> & io_list, std::list<RenderAf*> & i_renders, af::Work::SolvingMethod i_method)
+{
+	for( std::list<AfNodeSolve*>::iterator it = io_list.begin(); it != io_list.end(); )
 	{
-		// Get renders that node can run on:
-		std::list<RenderAf*> renders;
-		for( std::list<RenderAf*>::iterator rIt = i_renders.begin(); rIt != i_renders.end(); rIt++)
+		// Node can became not able to run after some other node solved.
+		if( false == (*it)->v_canRun())
 		{
-			// Check that the node can run this render:
-			if( false == (*it)->v_canRunOn( *rIt))
-				continue;
+			it = io_list.erase( it);
+			continue;
+		}
 
-			renders.push_back( *rIt);
+		RenderAf * render = SolveNode( *it, i_renders);
+		if( NULL == render )
+		{
+			it = io_list.erase( it);
+			continue;
 		}
 
-		// Sort renders:
-		renders.sort( MostReadyRender());
+		// Reposition solved node, as its need changed,
+		// list order is kept when solving user jobs by order.
+		if( i_method != af::Work::SolveByOrder )
+		{
+			AfNodeSolve * node = *it;
+			io_list.erase( it);
+			if( node->v_canRun())
+			{
+				if( af::Environment::getSolvingSimpler())
+					InsertSorted( io_list, node, GreaterPriorityThenOlderCreation());
+				else
+					InsertSorted( io_list, node, GreaterNeed());
+			}
+		}
 
-		RenderAf * render = (*it)->trySolve( renders, ms_monitorcontaier);
+		return render;
+	}
+
+	return NULL;
+}
+
+RenderAf * Solver::SolveList( std::list<AfNodeSolve*> & i_list, std::list<RenderAf*> & i_renders, af::Work::SolvingMethod i_method)
+{
+	SortList( i_list, i_method);
+
+	// Iterate solving nodes list:
+	for( std::list<AfNodeSolve*>::iterator it = i_list.begin(); it != i_list.end(); )
+	{
+		RenderAf * render = SolveNode( *it, i_renders);
 
 		if( render )
 			return render;
@@ -224,3 +406,23 @@ RenderAf * Solver::SolveList( std::list<AfNodeSolve*> & i_list, std::list<Render
 	return NULL;
 }
 
+RenderAf * Solver::SolveNode( AfNodeSolve * i_node, std::list<RenderAf*> & i_renders)
+{
+	// Get renders that node can run on:
+	std::list<RenderAf*> renders;
+	for( std::list<RenderAf*>::iterator rIt = i_renders.begin(); rIt != i_renders.end(); rIt++)
+	{
+		// Check that the node can run this render:
+		if( false == i_node->v_canRunOn( *rIt))
+			continue;
+
+		renders.push_back( *rIt);
+	}
+
+	// Sort renders,
+	// filtering keeps the order of already sorted renders.
+	if( false == ms_renders_sorted )
+		renders.sort( MostReadyRender());
+
+	return i_node->trySolve( renders, ms_monitorcontaier);
+}
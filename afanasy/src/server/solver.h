@@ -26,6 +26,32 @@ public:
 
 	static RenderAf * SolveList( std::list<AfNodeSolve*> & i_list, std::list<RenderAf*> & i_renders, af::Work::SolvingMethod i_method);
 
+	/// Whether nodes keep their solve lists sorted for the whole solve.
+	static inline bool IsIncremental() { return ms_renders_sorted; }
+
+	/// Remove nodes that can't run and sort list, once per solve.
+	static void SortList( std::list<AfNodeSolve*> & io_list, af::Work::SolvingMethod i_method);
+
+	/// Solve list sorted by \c SortList, keeping it sorted.
+	/** Solved node is repositioned, not solved nodes are removed. **/
+	static RenderAf * SolveSortedList( std::list<AfNodeSolve*> & io_list, std::list<RenderAf*> & i_renders, af::Work::SolvingMethod i_method);
+
+private:
+	/// Solve nodes keeping nodes and renders lists sorted for the whole cycle.
+	void solveIncremental( std::list<AfNodeSolve*> & io_list, int & io_solve_cycle, int & io_tasks_solved);
+
+	/// Try to solve a node on renders it can run on.
+	static RenderAf * SolveNode( AfNodeSolve * i_node, std::list<RenderAf*> & i_renders);
+
+	/// Whether render is ready to run a task or can be waken to run it.
+	static bool isRenderSolvable( RenderAf * i_render);
+
+	/// Process solved render, returns \c true if render was waken.
+	static bool renderSolved( RenderAf * i_render, int & io_tasks_solved);
+
+	/// Tasks solved within the current second reached the speed limit.
+	static bool tasksSpeedReached();
+
 private:
 	static JobContainer     * ms_jobcontainer;
 	static RenderContainer  * ms_rendercontainer;
@@ -33,6 +59,13 @@ private:
 	static MonitorContainer * ms_monitorcontaier;
 
 	static int ms_solve_cycles_limit;
+
+	/// Renders awaken and tasks solved within the current second, since the limits period start.
 	static int ms_awaken_renders;
+	static int ms_tasks_solved;
+	static int64_t ms_limits_period;
+
+	/// Renders passed to nodes are already sorted by readiness.
+	static bool ms_renders_sorted;
 };
 
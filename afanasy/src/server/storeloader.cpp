@@ -0,0 +1,93 @@
+#include "storeloader.h"
+
+#include "../libafanasy/common/dlScopeLocker.h"
+#include "../libafanasy/common/dlThread.h"
+
+#include "../libafanasy/environment.h"
+
+#include "jobaf.h"
+#include "runcycle.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+StoreLoader::StoreLoader( const std::vector<std::string> & i_folders, std::vector<JobAf*> & o_jobs):
+	m_folders( i_folders),
+	m_jobs( o_jobs),
+	m_next( 0),
+	m_loaded( 0),
+	m_percent( 0),
+	m_time_start( RunCycle::NowMSec())
+{
+}
+
+void StoreLoader::LoadJobs( const std::vector<std::string> & i_folders, std::vector<JobAf*> & o_jobs)
+{
+	o_jobs.assign( i_folders.size(), NULL);
+	if( i_folders.empty())
+		return;
+
+	StoreLoader loader( i_folders, o_jobs);
+
+	int threads_num = af::Environment::getServerStoreLoadThreads();
+	if( threads_num > int( i_folders.size()))
+		threads_num = i_folders.size();
+
+	// Current thread loads too, so one thread less is started.
+	std::vector<DlThread*> threads;
+	for( int i = 1; i < threads_num; i++)
+	{
+		DlThread * thread = new DlThread();
+		if( thread->Start( &ThreadFunc, &loader) != 0 )
+		{
+			AF_ERR << "Failed to start store loading thread.";
+			delete thread;
+			break;
+		}
+		threads.push_back( thread);
+	}
+
+	AF_LOG << "Reading " << i_folders.size() << " jobs in " << threads.size() + 1 << " threads...";
+
+	loader.run();
+
+	for( int i = 0; i < threads.size(); i++)
+	{
+		threads[i]->Join();
+		delete threads[i];
+	}
+}
+
+void StoreLoader::ThreadFunc( void * i_loader)
+{
+	((StoreLoader*)i_loader)->run();
+}
+
+void StoreLoader::run()
+{
+	for(;;)
+	{
+		int index;
+		{
+			DlScopeLocker lock( &m_mutex);
+			if( m_next >= int( m_folders.size()))
+				return;
+			index = m_next++;
+		}
+
+		// Each thread writes only its own vector items.
+		m_jobs[index] = new JobAf( m_folders[index]);
+
+		DlScopeLocker lock( &m_mutex);
+		m_loaded++;
+		int percent = 100 * m_loaded / m_folders.size();
+		if( percent / 10 > m_percent / 10 )
+		{
+			m_percent = percent;
+			AF_LOG << "Jobs read: " << m_loaded << " of " << m_folders.size()
+				<< " (" << percent << "%) in " << RunCycle::NowMSec() - m_time_start << " msec";
+		}
+	}
+}
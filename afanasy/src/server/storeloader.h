@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../libafanasy/common/dlMutex.h"
+
+#include "../libafanasy/name_af.h"
+
+class JobAf;
+
+/// Reads stored jobs on server start using several threads.
+/** Jobs construction (store files reading and parsing) is performed in parallel.
+*** Registration should be done by the caller, in the folders order. **/
+class StoreLoader
+{
+public:
+	/// Construct jobs from store folders.
+	/** \c o_jobs has the same order as \c i_folders. **/
+	static void LoadJobs( const std::vector<std::string> & i_folders, std::vector<JobAf*> & o_jobs);
+
+private:
+	StoreLoader( const std::vector<std::string> & i_folders, std::vector<JobAf*> & o_jobs);
+
+	static void ThreadFunc( void * i_loader);
+
+	void run();
+
+private:
+	const std::vector<std::string> & m_folders;
+	std::vector<JobAf*> & m_jobs;
+
+	DlMutex m_mutex;
+	int m_next;    ///< Next folder to load.
+	int m_loaded;  ///< Number of loaded folders, for progress output.
+	int m_percent; ///< Last progress output percent.
+	int64_t m_time_start;
+};
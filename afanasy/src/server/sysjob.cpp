@@ -72,7 +72,7 @@ std::string const SysTask::v_getInfo(bool full) const
 
 void SysTask::v_monitor( MonitorContainer * monitoring) const {}
 void SysTask::v_store() {}
-void SysTask::v_writeTaskOutput( const char * i_data, int i_size) const {}
+void SysTask::v_writeTaskOutput( const char *, int, bool, bool) const {}
 
 void SysTask::v_appendLog( const std::string & message)
 {
@@ -162,7 +162,7 @@ void SysTask::v_updateState( const af::MCTaskUp & taskup, RenderContainer * rend
 		message += "\n";
 		message += "=======================================================";
 		message += "\n";
-		message += std::string( taskup.getData(), taskup.getDataLen());
+		message += taskup.getDataString();
 		message += "\n";
 		message += "=======================================================";
 		((SysBlock*)(m_block))->appendTaskLog(message);
@@ -195,6 +195,7 @@ void SysBlock::addCommand( SysCmd * syscmd)
 {
 	m_commands.push_back( syscmd);
 	m_taskprogress->state |= AFJOB::STATE_READY_MASK;
+	m_data->setTaskReadyHint( 0);
 }
 
 bool SysBlock::isReady() const
@@ -212,7 +213,10 @@ bool SysBlock::isReady() const
 	}
 
 	if( ready )
+	{
 		m_taskprogress->state |= AFJOB::STATE_READY_MASK;
+		m_data->setTaskReadyHint( 0);
+	}
 
 	return ready;
 }
@@ -410,6 +414,7 @@ bool SysBlock::v_refresh( time_t currentTime, RenderContainer * renders, Monitor
 	else if( blockProgress_changed)
 	{
 		// Add block to monitoring if it was not, but has changes
+		setModified();
 		if( monitoring ) monitoring->addBlock( af::Msg::TBlocksProgress, m_data);
 	}
 
@@ -2,6 +2,7 @@
 
 #include "../include/afanasy.h"
 
+#include "../libafanasy/common/dlScopeLocker.h"
 #include "../libafanasy/environment.h"
 #include "../libafanasy/job.h"
 #include "../libafanasy/blockdata.h"
@@ -22,37 +23,24 @@
 #include "../include/macrooutput.h"
 #include "../libafanasy/logger.h"
 
+DlMutex Task::ms_store_mutex;
+
 Task::Task( Block * taskBlock, af::TaskProgress * taskProgress, int taskNumber):
+   m_solved_epoch( 0),
+   m_progress( taskProgress),
    m_block( taskBlock),
    m_number( taskNumber),
-   m_progress( taskProgress),
    m_run( NULL),
-	m_listen_count( 0)
+   m_listen_count( 0)
 {
 	// If job is not from store, it is just came from network
 	// and so no we do not need to read anything
 	if( false == m_block->m_job->isFromStore()) return;
 
-	initStoreFolders();
-
-	// Get existing files list
-	if( af::pathIsFolder( m_store_dir_files))
-		m_stored_files = af::getFilesList( m_store_dir_files);
+	// Read task progress, if it was not read from job tasks progress log
+	if( m_block->m_job->isTaskProgressLoaded( m_block->m_data->getBlockNum(), m_number)) return;
 
-	// Set thumbnail for a job if was not:
-	if( m_stored_files.size() && ( false == m_block->m_job->hasThumbnail() ))
-	{
-		std::string filename = m_store_dir_files + AFGENERAL::PATH_SEPARATOR + m_stored_files[0];
-		int size;
-		char * data = af::fileRead( filename, &size);
-		if( data )
-		{
-			m_block->m_job->setThumbnail( filename, size, data);
-			delete [] data;
-		}
-	}
-
-	// Read task progress
+	initStoreFolders();
 	if( false == af::pathFileExists( m_store_file_progress)) return;
 
 	int size;
@@ -68,6 +56,7 @@ Task::Task( Block * taskBlock, af::TaskProgress * taskProgress, int taskNumber):
 	}
 
 	m_progress->jsonRead( document);
+	m_block->m_job->taskProgressReadFromFolder();
 
 	delete [] data;
 	delete [] res;
@@ -78,8 +67,13 @@ Task::~Task()
    if( m_run) delete m_run;
 }
 
-void Task::initStoreFolders()
+void Task::initStoreFolders() const
 {
+	DlScopeLocker lock( &ms_store_mutex);
+
+	if( m_store_dir.size())
+		return;
+
 	m_store_dir = m_block->m_job->getTasksDir() + AFGENERAL::PATH_SEPARATOR
 		+ af::itos( m_block->m_data->getBlockNum())
 		+ '.' + af::itos( m_number);
@@ -87,6 +81,10 @@ void Task::initStoreFolders()
 	m_store_dir_output = m_store_dir + AFGENERAL::PATH_SEPARATOR + "output";
 	m_store_dir_files = m_store_dir + AFGENERAL::PATH_SEPARATOR + "files";
 	m_store_file_progress = m_store_dir + AFGENERAL::PATH_SEPARATOR + "progress.json";
+
+	// Get existing files list
+	if( m_block->m_job->isFromStore() && af::pathIsFolder( m_store_dir_files))
+		m_stored_files = af::getFilesList( m_store_dir_files);
 }
 
 af::TaskExec * Task::genExec() const
@@ -104,6 +102,7 @@ void Task::v_start( af::TaskExec * i_taskexec, RenderAf * i_render, MonitorConta
          ((TaskRunMulti*)(m_run))->addHost( i_taskexec, i_render, i_monitoring);
       else
          m_run = new TaskRunMulti( this, i_taskexec, m_progress, m_block, i_render, i_monitoring, io_running_tasks_counter, io_running_capacity_counter);
+      m_block->taskChanged( m_number);
       return;
    }
 
@@ -117,6 +116,7 @@ void Task::v_start( af::TaskExec * i_taskexec, RenderAf * i_render, MonitorConta
 	i_taskexec->listenOutput( m_listen_count > 0);
 
 	m_run = new TaskRun( this, i_taskexec, m_progress, m_block, i_render, i_monitoring, io_running_tasks_counter, io_running_capacity_counter);
+	m_block->taskChanged( m_number);
 }
 
 void Task::reconnect( af::TaskExec * i_taskexec, RenderAf * i_render, MonitorContainer * i_monitoring, int32_t * io_running_tasks_counter, int64_t * io_running_capacity_counter)
@@ -156,16 +156,26 @@ void Task::v_updateState( const af::MCTaskUp & taskup, RenderContainer * renders
 	if( log.size())
 		v_appendLog( log);
 
-	if( taskup.getDataLen() || log.size())
+	if( taskup.getDataOffset() >= 0 )
 	{
+		writeOutputStream( taskup, log);
+	}
+	else if( taskup.getDataLen() || log.size())
+	{
+		// Render sends the whole output if it does not stream it, or streaming was stopped:
+		if( taskup.getDataLen())
+			m_run->setOutputOffset( -1);
+
 		const char * data = log.c_str();
 		int size = log.size();
+		bool compressed = false;
 		if( taskup.getDataLen())
 		{
 			data = taskup.getData();
 			size = taskup.getDataLen();
+			compressed = taskup.isDataCompressed();
 		}
-		v_writeTaskOutput( data, size);
+		v_writeTaskOutput( data, size, compressed);
 	}
 
 	if( taskup.hasListened())
@@ -183,6 +193,8 @@ void Task::v_updateState( const af::MCTaskUp & taskup, RenderContainer * renders
 	storeFiles( taskup);
 
 	deleteRunningZombie();
+
+	m_block->taskChanged( m_number);
 }
 
 void Task::deleteRunningZombie()
@@ -263,6 +275,24 @@ void Task::v_refresh( time_t currentTime, RenderContainer * renders, MonitorCont
    deleteRunningZombie();
 }
 
+bool Task::isRefreshNeeded() const
+{
+	if( m_run )
+		return true;
+
+	if( m_progress->state & AFJOB::STATE_WAITRECONNECT_MASK )
+		return true;
+
+	// Error task is retried automatically, while retries number is not reached:
+	if(( m_progress->state & AFJOB::STATE_ERROR_MASK ) && ( m_progress->errors_count <= m_block->getErrorsRetries()))
+		return true;
+
+	if( m_errorHosts.size() && ( m_block->getErrorsForgiveTime() > 0 ))
+		return true;
+
+	return false;
+}
+
 void Task::restart( const std::string & i_message, RenderContainer * i_renders, MonitorContainer * i_monitoring, uint32_t i_state)
 {
 	if( i_state != 0 )
@@ -276,6 +306,8 @@ void Task::restart( const std::string & i_message, RenderContainer * i_renders,
 			return;
 	}
 
+	m_block->taskChanged( m_number);
+
 	if( m_run )
 	{
 		m_run->restart( i_message, i_renders, i_monitoring);
@@ -292,6 +324,7 @@ void Task::restart( const std::string & i_message, RenderContainer * i_renders,
 void Task::skip( const std::string & message, RenderContainer * renders, MonitorContainer * monitoring)
 {
    if( m_progress->state & AFJOB::STATE_DONE_MASK) return;
+   m_block->taskChanged( m_number);
    if( m_run ) m_run->skip( message, renders, monitoring);
    else
    {
@@ -305,6 +338,9 @@ void Task::skip( const std::string & message, RenderContainer * renders, Monitor
 
 void Task::errorHostsAppend( const std::string & hostname)
 {
+   // Error hosts should be forgiven on refresh
+   m_block->taskChanged( m_number);
+
    std::list<std::string>::iterator hIt = m_errorHosts.begin();
    std::list<int>::iterator cIt = m_errorHostsCounts.begin();
    std::list<time_t>::iterator tIt = m_errorHostsTime.begin();
@@ -364,18 +400,25 @@ void Task::getErrorHostsList( std::list<std::string> & o_list) const
 
 void Task::v_monitor( MonitorContainer * monitoring) const
 {
+   m_block->setTaskModified( m_number);
    if( monitoring ) monitoring->addTask( m_block->m_job->getId(), m_block->m_data->getBlockNum(), m_number, m_progress);
 }
 
 void Task::v_store()
 {
-	if( m_store_dir.empty())
-		initStoreFolders();
+	if( af::Environment::getServerStoreTasksProgressLog())
+	{
+		m_block->m_job->storeTaskProgress( m_block->m_data->getBlockNum(), m_number);
+		return;
+	}
+
+	initStoreFolders();
 
 	std::ostringstream str;
 	m_progress->jsonWrite( str);
-	AFCommon::QueueFileWrite( new FileData( str, m_store_file_progress,
-		m_store_dir));
+	FileData * filedata = new FileData( str, m_store_file_progress, m_store_dir);
+	filedata->setFolderRoot( m_block->m_job->getTasksDir());
+	AFCommon::QueueFileWrite( filedata);
 }
 
 void Task::v_appendLog( const std::string & message)
@@ -384,15 +427,81 @@ void Task::v_appendLog( const std::string & message)
    while( m_logStringList.size() > af::Environment::getTaskLogLinesMax() ) m_logStringList.pop_front();
 }
 
-void Task::v_writeTaskOutput( const char * i_data, int i_size) const
+void Task::writeOutputStream( const af::MCTaskUp & i_taskup, const std::string & i_log)
 {
-//	AFCommon::QueueFileWrite( new FileData( taskup.getData(), taskup.getDataLen(), getOutputFileName( m_progress->starts_count),
-	AFCommon::QueueFileWrite( new FileData( i_data, i_size, getOutputFileName( m_progress->starts_count),
-		m_store_dir_output));
+	int64_t received = m_run->getOutputOffset();
+
+	if( i_taskup.getDataLen() == 0 )
+	{
+		// Nothing was streamed, task can have a log only:
+		if(( received < 0 ) && i_log.size())
+			v_writeTaskOutput( i_log.c_str(), i_log.size());
+		return;
+	}
+
+	// Finished task state with the last portion is sent until server closes the task:
+	if( i_taskup.getDataOffset() < received )
+		return;
+
+	bool append = ( received >= 0 );
+	if( received < 0 )
+		received = 0;
+
+	// Portion was lost, or server was restarted while task was running:
+	if( i_taskup.getDataOffset() > received )
+	{
+		std::string gap = "\n\n... " + af::itos( i_taskup.getDataOffset() - received) + " bytes of output were not received ...\n\n";
+		v_writeTaskOutput( gap.c_str(), gap.size(), false, append);
+		append = true;
+	}
+
+	v_writeTaskOutput( i_taskup.getData(), i_taskup.getDataLen(), i_taskup.isDataCompressed(), append);
+
+	m_run->setOutputOffset( i_taskup.getDataOffset() + i_taskup.getDataRawLen());
+}
+
+void Task::v_writeTaskOutput( const char * i_data, int i_size, bool i_compressed, bool i_append) const
+{
+	std::string filename = getOutputFileName( m_progress->starts_count);
+	int level = af::Environment::getServerOutputCompressLevel();
+
+	// Render can send compressed output, store it as is if compression is enabled:
+	std::string buffer;
+	if( i_compressed && ( level <= 0 ))
+	{
+		std::string err;
+		if( false == af::gzDecompress( i_data, i_size, buffer, -1, &err))
+			AF_ERR << err;
+		i_data = buffer.data();
+		i_size = buffer.size();
+		i_compressed = false;
+	}
+	else if(( false == i_compressed ) && ( level > 0 ))
+	{
+		if( af::gzCompress( i_data, i_size, buffer, level))
+		{
+			i_data = buffer.data();
+			i_size = buffer.size();
+			i_compressed = true;
+		}
+	}
+
+	if( i_compressed )
+		filename += ".gz";
+
+	FileData * filedata = new FileData( i_data, i_size, filename, m_store_dir_output);
+	filedata->setFolderRoot( m_block->m_job->getTasksDir());
+	// Appended compressed portions are separate gzip members:
+	if( i_append )
+		filedata->setAppend();
+	AFCommon::QueueFileWrite( filedata);
 }
 
 void Task::storeFiles( const af::MCTaskUp & i_taskup)
 {
+	if( i_taskup.getFilesNum())
+		initStoreFolders();
+
 	for( int i = 0; i < i_taskup.getFilesNum(); i++)
 	{
 		std::string filename = i_taskup.getFileName(i);
@@ -414,8 +523,10 @@ void Task::storeFiles( const af::MCTaskUp & i_taskup)
 		if( i == 0 )
 			m_block->m_job->setThumbnail( filename, i_taskup.getFileSize(i), i_taskup.getFileData(i));
 
-		AFCommon::QueueFileWrite( new FileData( i_taskup.getFileData(i), i_taskup.getFileSize(i), filename,
-			m_store_dir_files));
+		FileData * filedata = new FileData( i_taskup.getFileData(i), i_taskup.getFileSize(i), filename,
+			m_store_dir_files);
+		filedata->setFolderRoot( m_block->m_job->getTasksDir());
+		AFCommon::QueueFileWrite( filedata);
 	}
 }
 
@@ -423,6 +534,8 @@ af::Msg * Task::getStoredFiles() const
 {
 	af::MCTaskUp taskup( -1, m_block->m_job->getId(), m_block->m_data->getBlockNum(), m_number);
 
+	initStoreFolders();
+
 	for( int i = 0; i < m_stored_files.size(); i++)
 	{
 		std::string filename = m_store_dir_files + AFGENERAL::PATH_SEPARATOR + m_stored_files[i];
@@ -454,6 +567,8 @@ void Task::getStoredFiles( std::ostringstream & i_str) const
 	i_str << ",\n\"task_id\":" << m_number;
 	i_str << ",\n\"files\":[";
 
+	initStoreFolders();
+
 	for( int i = 0; i < m_stored_files.size(); i++)
 	{
 		if( i ) i_str << ",";
@@ -525,6 +640,7 @@ void Task::listenOutput(  RenderContainer * i_renders, bool i_subscribe)
 
 const std::string Task::getOutputFileName( int i_starts_count) const
 {
+	initStoreFolders();
 	return m_store_dir_output + AFGENERAL::PATH_SEPARATOR + af::itos( i_starts_count) + ".txt";
 }
 
@@ -545,7 +661,8 @@ void Task::getOutput( af::MCTask & io_mctask, std::string & o_error) const
 
 	if( start_num == 0 )
 	{
-		if( m_run && m_run->notZombie())
+		// Streamed output of running task is stored, there is no need to ask render:
+		if( m_run && m_run->notZombie() && ( m_run->getOutputOffset() < 0 ))
 		{
 			io_mctask.m_render_id = m_run->v_getRunningRenderID( o_error);
 			return;
@@ -556,7 +673,12 @@ void Task::getOutput( af::MCTask & io_mctask, std::string & o_error) const
 		}
 	}
 
-	io_mctask.setOutput( getOutputFileName( start_num));
+	// Output can be stored compressed:
+	std::string filename = getOutputFileName( start_num);
+	if(( false == af::pathFileExists( filename)) && af::pathFileExists( filename + ".gz"))
+		filename += ".gz";
+
+	io_mctask.setOutput( filename);
 }
 
 const std::string Task::v_getInfo( bool full) const
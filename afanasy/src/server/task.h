@@ -2,6 +2,7 @@
 
 #include "../include/afjob.h"
 
+#include "../libafanasy/common/dlMutex.h"
 #include "../libafanasy/msgclasses/mctask.h"
 #include "../libafanasy/name_af.h"
 #include "../libafanasy/taskprogress.h"
@@ -55,7 +56,7 @@ public:
 
 	/// Store task output:
 	/// Need to be virtual, as system job task output storing is not needed
-	virtual void v_writeTaskOutput( const char * i_data, int i_size) const;
+	virtual void v_writeTaskOutput( const char * i_data, int i_size, bool i_compressed = false, bool i_append = false) const;
 
 	virtual void v_monitor( MonitorContainer * monitoring) const;
 
@@ -81,7 +82,10 @@ public:
 	inline bool isDone()    const { return m_progress->state & AFJOB::STATE_DONE_MASK;    }
 	inline bool isError()   const { return m_progress->state & AFJOB::STATE_ERROR_MASK;   }
 
-	bool m_solved;
+	/// Whether task has something to check on refresh: running, waiting reconnect, retrying errors or forgiving error hosts.
+	bool isRefreshNeeded() const;
+
+	uint32_t m_solved_epoch; ///< Job solving epoch when task was tried to generate.
 
 protected:
 	af::TaskProgress * m_progress;
@@ -89,19 +93,24 @@ protected:
 	Block * m_block;
 
 private:
-	void initStoreFolders();
+	/// Store paths and stored files list are initialized on the first output or files access,
+	/// not to touch each task folder on server start.
+	void initStoreFolders() const;
 	void storeFiles( const af::MCTaskUp & i_taskup);
 	void deleteRunningZombie();
 
+	/// Append streamed output portion to the task output file.
+	void writeOutputStream( const af::MCTaskUp & i_taskup, const std::string & i_log);
+
 private:
 	int m_number;
 
-	std::string m_store_dir;
-	std::string m_store_dir_output;
-	std::string m_store_dir_files;
-	std::string m_store_file_progress;
+	mutable std::string m_store_dir;
+	mutable std::string m_store_dir_output;
+	mutable std::string m_store_dir_files;
+	mutable std::string m_store_file_progress;
 
-	std::vector<std::string> m_stored_files;
+	mutable std::vector<std::string> m_stored_files;
 	std::vector<std::string> m_parsed_files;
 
 	TaskRun * m_run;
@@ -111,5 +120,8 @@ private:
 	std::list<time_t>       m_errorHostsTime;   ///< Time of the last error
 
 	int m_listen_count;
+
+	/// Tasks can be read by several threads, store is initialized on the first access.
+	static DlMutex ms_store_mutex;
 };
 
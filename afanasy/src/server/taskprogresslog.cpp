@@ -0,0 +1,189 @@
+#include "taskprogresslog.h"
+
+#include "../include/afanasy.h"
+
+#include "../libafanasy/environment.h"
+#include "../libafanasy/jobprogress.h"
+
+#include "afcommon.h"
+
+#define AFOUTPUT
+#undef AFOUTPUT
+#include "../include/macrooutput.h"
+#include "../libafanasy/logger.h"
+
+TaskProgressLog::TaskProgressLog():
+	m_records( 0),
+	m_folder_read( false)
+{
+}
+
+TaskProgressLog::~TaskProgressLog()
+{
+}
+
+void TaskProgressLog::init( const std::string & i_store_dir)
+{
+	m_file_name = i_store_dir + AFGENERAL::PATH_SEPARATOR + "tasks_progress.log";
+}
+
+bool TaskProgressLog::read( af::JobProgress * io_progress)
+{
+	m_records = 0;
+
+	m_loaded.resize( io_progress->getBlocksNum());
+	for( int b = 0; b < io_progress->getBlocksNum(); b++)
+		m_loaded[b].assign( io_progress->getTasksNum( b), false);
+
+	if( false == af::pathFileExists( m_file_name))
+		return false;
+
+	int size;
+	char * data = af::fileRead( m_file_name, &size);
+	if( data == NULL )
+		return false;
+
+	int bad_records = 0;
+	char * line = data;
+	for( int i = 0; i < size; i++)
+	{
+		if( data[i] != '\n' )
+			continue;
+
+		// Record is parsed in place, line end is replaced with a string terminator.
+		// Not finished last line (server was stopped while writing) has no line end and is skipped.
+		data[i] = '\0';
+
+		rapidjson::Document document;
+		if( document.ParseInsitu<0>( line).HasParseError() || ( false == document.IsObject()))
+		{
+			bad_records++;
+			line = data + i + 1;
+			continue;
+		}
+		line = data + i + 1;
+
+		int32_t b = -1, t = -1;
+		af::jr_int32("b", b, document);
+		af::jr_int32("t", t, document);
+		const JSON & progress = document["p"];
+
+		if(( b < 0 ) || ( b >= io_progress->getBlocksNum()) ||
+			( t < 0 ) || ( t >= io_progress->getTasksNum( b)) ||
+			( false == progress.IsObject()))
+		{
+			bad_records++;
+			continue;
+		}
+
+		io_progress->tp[b][t]->jsonRead( progress);
+		m_loaded[b][t] = true;
+		m_records++;
+	}
+
+	delete [] data;
+
+	if( bad_records )
+		AF_WARN << "Tasks progress log has " << bad_records << " bad records: " << m_file_name;
+
+	return true;
+}
+
+bool TaskProgressLog::isLoaded( int i_block, int i_task) const
+{
+	if(( i_block < 0 ) || ( i_block >= int( m_loaded.size())))
+		return false;
+	if(( i_task < 0 ) || ( i_task >= int( m_loaded[i_block].size())))
+		return false;
+
+	return m_loaded[i_block][i_task];
+}
+
+void TaskProgressLog::clearLoaded()
+{
+	std::vector<std::vector<bool> > empty;
+	m_loaded.swap( empty);
+}
+
+void TaskProgressLog::writeRecord( int i_block, int i_task, const af::TaskProgress * i_tp, std::ostringstream & o_str)
+{
+	o_str << "{\"b\":" << i_block << ",\"t\":" << i_task << ",\"p\":";
+	i_tp->jsonWrite( o_str);
+	o_str << "}\n";
+}
+
+bool TaskProgressLog::isOversized( const af::JobProgress * i_progress) const
+{
+	int compact_factor = af::Environment::getServerStoreTasksProgressLogCompact();
+	if( compact_factor <= 0 )
+		return false;
+
+	int tasks_num = 0;
+	for( int b = 0; b < i_progress->getBlocksNum(); b++)
+		tasks_num += i_progress->getTasksNum( b);
+
+	return m_records >= tasks_num * compact_factor;
+}
+
+void TaskProgressLog::append( int i_block, int i_task, const af::JobProgress * i_progress)
+{
+	if( m_file_name.empty())
+		return;
+
+	if( isOversized( i_progress))
+	{
+		compact( i_progress);
+		return;
+	}
+
+	std::ostringstream str;
+	writeRecord( i_block, i_task, i_progress->tp[i_block][i_task], str);
+
+	FileData * filedata = new FileData( str, m_file_name);
+	filedata->setAppend();
+	AFCommon::QueueFileWrite( filedata);
+
+	m_records++;
+}
+
+void TaskProgressLog::compact( const af::JobProgress * i_progress)
+{
+	if( m_file_name.empty())
+		return;
+
+	std::ostringstream str;
+	m_records = 0;
+	for( int b = 0; b < i_progress->getBlocksNum(); b++)
+		for( int t = 0; t < i_progress->getTasksNum( b); t++)
+		{
+			writeRecord( b, t, i_progress->tp[b][t], str);
+			m_records++;
+		}
+
+	// Whole file write is atomic (temporary file is renamed),
+	// records appended before are in this data already.
+	AFCommon::QueueFileWrite( new FileData( str, m_file_name));
+}
+
+void TaskProgressLog::compactRead( const af::JobProgress * i_progress)
+{
+	// Log is not rewritten on each server start, as most jobs are not changed:
+	if( m_folder_read || isOversized( i_progress))
+		compact( i_progress);
+
+	m_folder_read = false;
+}
+
+void TaskProgressLog::remove()
+{
+	if( m_file_name.empty())
+		return;
+
+	// Removal is queued after log writes queued before:
+	std::ostringstream str;
+	FileData * filedata = new FileData( str, m_file_name);
+	filedata->setRemove();
+	AFCommon::QueueFileWrite( filedata);
+
+	m_records = 0;
+}
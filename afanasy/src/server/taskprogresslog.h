@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../libafanasy/name_af.h"
+
+/// Job tasks progress store as a single append-only file.
+/** Each task progress store appends a record line to the job log,
+*** instead of rewriting a progress file in a task folder.
+*** The last record of a task wins on reading.
+*** When log has too many records, it is rewritten with the current progress of all tasks.
+*** All writes are performed by the file write queue, in the order of calls. **/
+class TaskProgressLog
+{
+public:
+	TaskProgressLog();
+	~TaskProgressLog();
+
+	/// Set log file location in a job store folder.
+	void init( const std::string & i_store_dir);
+
+	inline const std::string & getFileName() const { return m_file_name; }
+
+	/// Read log records to job progress, return false if there is no log.
+	/** Tasks that have records are marked as loaded. **/
+	bool read( af::JobProgress * io_progress);
+
+	/// Whether task progress was read from log.
+	bool isLoaded( int i_block, int i_task) const;
+
+	/// Free loaded tasks marks, they are needed on a job construction only.
+	void clearLoaded();
+
+	/// Append task progress record, rewrite the whole log if it has too many records.
+	void append( int i_block, int i_task, const af::JobProgress * i_progress);
+
+	/// Rewrite log with current progress of all tasks.
+	void compact( const af::JobProgress * i_progress);
+
+	/// Task progress was read from its folder, as it was not in log.
+	inline void setFolderRead() { m_folder_read = true; }
+
+	/// Rewrite log after reading, only if some tasks progress was read from folders,
+	/// or it has too many records.
+	void compactRead( const af::JobProgress * i_progress);
+
+	/// Remove log file, when progress is stored in tasks folders.
+	void remove();
+
+private:
+	static void writeRecord( int i_block, int i_task, const af::TaskProgress * i_tp, std::ostringstream & o_str);
+
+	/// Whether log has too many records for the number of tasks.
+	bool isOversized( const af::JobProgress * i_progress) const;
+
+private:
+	std::string m_file_name;
+
+	int m_records;      ///< Number of records in log file.
+	bool m_folder_read; ///< Some tasks progress was read from their folders.
+
+	std::vector<std::vector<bool> > m_loaded;
+};
@@ -39,7 +39,8 @@ TaskRun::TaskRun( Task * runningTask,
 	m_running_tasks_counter( i_running_tasks_counter),
 	m_running_capacity_counter( i_running_capacity_counter),
    m_stopTime( 0),
-   m_zombie( false)
+   m_zombie( false),
+	m_output_offset( -1)
 {
 	AF_DEBUG << "TaskRun::TaskRun: " << m_block->m_job->getName() << "[" << m_block->m_data->getBlockNum() << "][" << m_tasknum << "]:";
 	(*m_running_tasks_counter)++;
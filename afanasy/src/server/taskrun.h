@@ -58,6 +58,10 @@ public:
 
    const std::string & getTaskName() const { if( m_exec) return m_exec->getName(); else return ms_no_name;}
 
+/// Streamed output bytes received from render, negative if render does not stream output.
+	inline int64_t getOutputOffset() const { return m_output_offset; }
+	inline void setOutputOffset( int64_t i_offset) { m_output_offset = i_offset; }
+
 /// Calculate memory totally allocated by class instance
    int calcWeight() const;
 
@@ -84,5 +88,7 @@ private:
    uint32_t m_stopTime;         ///< Time, when running task was asked to stop.
    bool m_zombie;
 
+	int64_t m_output_offset;
+
    static std::string ms_no_name;
 };
@@ -3,11 +3,15 @@
 #include "monitoraf.h"
 #include "monitorcontainer.h"
 #include "rendercontainer.h"
+#include "renderheartbeats.h"
+#include "responsecache.h"
+#include "runcycle.h"
 #include "threadargs.h"
 #include "usercontainer.h"
 
 #include "../libafanasy/farm.h"
 #include "../libafanasy/msgclasses/mctask.h"
+#include "../libafanasy/regexp.h"
 #include "../libafanasy/rapidjson/stringbuffer.h"
 #include "../libafanasy/rapidjson/prettywriter.h"
 
@@ -17,18 +21,110 @@
 
 af::Msg * jsonSaveObject( rapidjson::Document & i_obj);
 
+/// Generate nodes list response using responses cache.
+/** Generation is taken under the same container locks as the list is generated,
+*** so the cached response always corresponds to its generation. **/
+static af::Msg * generateListCached( ThreadArgs * i_args, const std::string & i_type, bool i_full,
+	const std::vector<int32_t> & i_uids, bool i_json, int64_t i_client_generation)
+{
+	std::string key = i_type;
+	if( i_full && ( i_type == "jobs" ) && i_uids.empty()) key += ":full";
+	if( false == i_json ) key += ":bin";
+	if( i_type == "jobs" )
+		for( int i = 0; i < i_uids.size(); i++)
+			key += std::string(":") + af::itos( i_uids[i]);
+
+	const std::vector<int32_t> ids;
+	const std::string mask;
+	int64_t generation;
+	af::Msg * msg;
+
+	if( i_type == "jobs" )
+	{
+		AfContainerLock jLock( i_args->jobs, AfContainerLock::READLOCK);
+		if( i_uids.size())
+		{
+			AfContainerLock uLock( i_args->users, AfContainerLock::READLOCK);
+			generation = i_args->monitors->getGeneration( i_type);
+			msg = ResponseCache::Get( key, generation, i_client_generation, i_json);
+			if( msg ) return msg;
+			msg = i_args->users->generateJobsList( i_uids, i_type, i_json);
+		}
+		else
+		{
+			generation = i_args->monitors->getGeneration( i_type);
+			msg = ResponseCache::Get( key, generation, i_client_generation, i_json);
+			if( msg ) return msg;
+			msg = i_args->jobs->generateList( i_full ? af::Msg::TJob : af::Msg::TJobsList, i_type, ids, mask, i_json);
+		}
+	}
+	else
+	{
+		AfContainerLock lock( i_args->users, AfContainerLock::READLOCK);
+		generation = i_args->monitors->getGeneration( i_type);
+		msg = ResponseCache::Get( key, generation, i_client_generation, i_json);
+		if( msg ) return msg;
+		msg = i_args->users->generateList( af::Msg::TUsersList, i_type, ids, mask, i_json);
+	}
+
+	return ResponseCache::Store( key, generation, msg, i_client_generation);
+}
+
+/// Get the first key of JSON root object without parsing, empty string if it can't be found.
+static std::string jsonFirstKey( const af::Msg * i_msg)
+{
+	const char * data = i_msg->data();
+	int len = i_msg->dataLen();
+	int i = 0;
+
+	while(( i < len ) && isspace((unsigned char)( data[i]))) i++;
+	if(( i >= len ) || ( data[i] != '{' )) return std::string();
+	i++;
+
+	while(( i < len ) && isspace((unsigned char)( data[i]))) i++;
+	if(( i >= len ) || ( data[i] != '"' )) return std::string();
+	i++;
+
+	int begin = i;
+	while(( i < len ) && ( data[i] != '"' ) && ( data[i] != '\\' )) i++;
+	if(( i >= len ) || ( data[i] != '"' )) return std::string();
+
+	return std::string( data + begin, i - begin);
+}
+
 af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 {
+	std::string key = jsonFirstKey( i_msg);
+
+	// This message for Run thread, it will be parsed there:
+	if( key == "action")
+		return NULL;
+
+	// Job registration message can be large, it is processed once and parsed in place without a copy.
+	// Other messages are parsed in a copy, as they can be processed again:
+	// get monitor events can wait, and an action can be passed to run thread.
 	rapidjson::Document document;
 	std::string error;
-	char * data = af::jsonParseMsg( document, i_msg, &error);
-	if( data == NULL )
+	char * data = NULL;
+	bool parsed = false;
+	if( key == "job")
+		parsed = af::jsonParseMsgInsitu( document, i_msg, &error);
+	else
+	{
+		data = af::jsonParseMsg( document, i_msg, &error);
+		parsed = data != NULL;
+	}
+
+	if( false == parsed )
 	{
 		AFCommon::QueueLogError( error);
 		delete i_msg;
 		return af::jsonMsgError(error);
 	}
 
+	if(( NULL == data ) && ( document.HasMember("get") || document.HasMember("action")))
+		return af::jsonMsgError("Job registration message should not contain other requests.");
+
 	af::Msg * o_msg_response = NULL;
 
 	JSON & getObj = document["get"];
@@ -53,12 +149,35 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 		std::string mask;
 		af::jr_string("mask", mask, getObj);
 
-		if( type == "jobs" )
+		std::vector<int32_t> uids;
+		af::jr_int32vec("uids", uids, getObj);
+
+		// Client sends a generation of jobs it has, to get changes only.
+		int64_t since = -1;
+		bool delta = json && ( type == "jobs" ) && af::jr_int64("since", since, getObj);
+
+		// Whole nodes lists are cached.
+		// Renders are not, as their resources, tasks percents and times change without events.
+		bool cacheable = ResponseCache::IsEnabled() && ids.empty() && mask.empty() && ( mode.empty() || full ) &&
+			( false == getObj.HasMember("users")) && ( false == getObj.HasMember("serials")) && ( false == delta ) &&
+			(( type == "jobs" ) || ( type == "users" ));
+
+		if( delta && ids.empty() && mask.empty() && mode.empty() && ( false == getObj.HasMember("users")))
+		{
+			AfContainerLock jLock( i_args->jobs,  AfContainerLock::READLOCK);
+			AfContainerLock uLock( i_args->users, AfContainerLock::READLOCK);
+			o_msg_response = i_args->jobs->generateDelta( since, uids, i_args->users);
+		}
+		else if( cacheable )
+		{
+			int64_t client_generation = -1;
+			af::jr_int64("generation", client_generation, getObj);
+			o_msg_response = generateListCached( i_args, type, full, uids, json, client_generation);
+		}
+		else if( type == "jobs" )
 		{
 			if( getObj.HasMember("uids"))
 			{
-				std::vector<int32_t> uids;
-				af::jr_int32vec("uids", uids, getObj);
 				if( uids.size())
 				{
 					AfContainerLock jLock( i_args->jobs,  AfContainerLock::READLOCK);
@@ -111,7 +230,7 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 					if( mctask.hasOutput()) // Reading output from file
 					{
 						int readsize = -1;
-						char * data = af::fileRead( mctask.getOutput(), &readsize, af::Msg::SizeDataMax, &error);
+						char * data = af::fileReadDecompress( mctask.getOutput(), &readsize, af::Msg::SizeDataMax, &error);
 						if( data )
 						{
 							mctask.updateOutput( std::string( data, readsize));
@@ -207,6 +326,8 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 					{
 						if( mode == "thumbnail" )
 							o_msg_response = job->writeThumbnail( binary);
+						else if(( mode == "progress" ) && delta )
+							o_msg_response = job->writeProgressDelta( since);
 						else if( mode == "progress" )
 							o_msg_response = job->writeProgress( json);
 						else if( mode == "error_hosts" )
@@ -286,6 +407,9 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 		}
 		else if( type == "monitors")
 		{
+			af::MonitorEvents events;
+			bool events_taken = false;
+			{
 			AfContainerLock lock( i_args->monitors, AfContainerLock::READLOCK);
 			if( mode.size())
 			{
@@ -300,13 +424,26 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 				if( monitor )
 				{
 					if( mode == "events")
-						o_msg_response = monitor->getEventsJSON();
+					{
+						monitor->takeEvents( events);
+						events_taken = true;
+					}
 					else if( mode == "log")
 						o_msg_response = monitor->writeLog( binary);
 				}
 			}
-			if( NULL == o_msg_response )
+			if(( NULL == o_msg_response ) && ( false == events_taken ))
 				o_msg_response = i_args->monitors->generateList( af::Msg::TMonitorsList, type, ids, mask, json);
+			}
+
+			// Events are serialized without monitors lock,
+			// request that asks to wait is held until monitor has events:
+			bool wait = false;
+			af::jr_bool("wait", wait, getObj);
+			if( events_taken && wait && events.isEmpty())
+				o_msg_response = new af::Msg( af::Msg::TMonitorEventsWait, ids[0]);
+			else if( events_taken )
+				o_msg_response = MonitorAf::EventsJSON( events);
 		}
 		else if( type == "files")
 		{
@@ -337,6 +474,29 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 		{
 			o_msg_response = af::jsonMsg( af::farm()->jsonWriteLimits() );
 		}
+		else if( type == "server" )
+		{
+			std::ostringstream str;
+			str << "{\"server\":{";
+			RunCycle::jsonWrite( str);
+			str << ",";
+			RenderHeartbeats::jsonWrite( str);
+			str << ",";
+			ResponseCache::jsonWrite( str);
+			str << ",";
+			AFCommon::DBJsonWrite( str);
+			{
+				AfContainerLock lock( i_args->jobs, AfContainerLock::READLOCK);
+				str << ",";
+				i_args->jobs->getDependIndex().jsonWrite( str);
+			}
+			int64_t hits = af::RegExp::getCacheHits();
+			int64_t misses = af::RegExp::getCacheMisses();
+			str << ",\"match_cache\":{\"hits\":" << hits << ",\"misses\":" << misses;
+			str << ",\"hit_rate\":" << (( hits + misses ) ? double( hits) / ( hits + misses ) : 0.0) << "}";
+			str << "}}";
+			o_msg_response = af::jsonMsg( str);
+		}
 		else
 		{
 			o_msg_response = af::jsonMsgError(std::string("Invalid get type = '") + type + "'");
@@ -362,6 +522,9 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 			// Job registration is a complex procedure.
 			// It locks and unlocks needed containers itself.
 			o_msg_response = i_args->jobs->registerJob( document["job"], i_args->users, i_args->monitors);
+
+			// New job tasks can be solved:
+			RunCycle::Wake();
 		}
 	}
 	else if( document.HasMember("monitor"))
@@ -424,7 +587,8 @@ af::Msg * threadProcessJSON( ThreadArgs * i_args, af::Msg * i_msg)
 		o_msg_response = jsonSaveObject( document);
 	}
 
-	delete [] data;
+	if( data )
+		delete [] data;
 
 	return o_msg_response;
 }
@@ -20,6 +20,8 @@
 #include "monitoraf.h"
 #include "monitorcontainer.h"
 #include "rendercontainer.h"
+#include "renderheartbeats.h"
+#include "runcycle.h"
 #include "threadargs.h"
 #include "usercontainer.h"
 
@@ -87,17 +89,30 @@ af::Msg* threadProcessMsgCase( ThreadArgs * i_args, af::Msg * i_msg)
 
 // ---------------------------------- Monitor ---------------------------------//
 	case af::Msg::TMonitorUpdateId:
+	case af::Msg::TMonitorEventsWait:
 	{
-	  AfContainerLock lock( i_args->monitors, AfContainerLock::READLOCK);
-		MonitorContainerIt it( i_args->monitors);
-		MonitorAf * node = it.getMonitor( i_msg->int32());
+		af::MonitorEvents events;
+		bool found = false;
+		{
+			AfContainerLock lock( i_args->monitors, AfContainerLock::READLOCK);
+			MonitorContainerIt it( i_args->monitors);
+			MonitorAf * node = it.getMonitor( i_msg->int32());
+			if( node )
+			{
+				node->takeEvents( events);
+				found = true;
+			}
+		}
 
-		if( node )
-			o_msg_response = node->getEventsBin();
+		// Events are serialized without monitors lock:
+		if( found && events.isEmpty() && ( i_msg->type() == af::Msg::TMonitorEventsWait ))
+			o_msg_response = new af::Msg( af::Msg::TMonitorEventsWait, i_msg->int32());
+		else if( found )
+			o_msg_response = MonitorAf::EventsBin( i_msg->int32(), events);
 		else
 			o_msg_response = new af::Msg( af::Msg::TMonitorId, 0);
 
-	  break;
+		break;
 	}
 
 // ---------------------------------- Render -------------------------------//
@@ -111,6 +126,9 @@ af::Msg* threadProcessMsgCase( ThreadArgs * i_args, af::Msg * i_msg)
 		RenderAf * newRender = new RenderAf( i_msg);
 		newRender->setAddressIP( i_msg->getAddress());
 		o_msg_response = i_args->renders->addRender( newRender, i_args->jobs, i_args->monitors);
+
+		// New render can take tasks:
+		RunCycle::Wake();
 		break;
 	}
 	case af::Msg::TRenderUpdate:
@@ -118,49 +136,17 @@ af::Msg* threadProcessMsgCase( ThreadArgs * i_args, af::Msg * i_msg)
 		af::RenderUpdate * rup = new af::RenderUpdate( i_msg);
 		bool render_found = false;
 
-		{
-			AfContainerLock rlock( i_args->renders, AfContainerLock::WRITELOCK);
-
-			RenderContainerIt rendersIt( i_args->renders);
-			RenderAf * render = rendersIt.getRender( rup->getId());
-
-			if( NULL == render)
-			{
-				// If there is not such online render, a zero id will be send.
-				// It is a signal for client to register again (may be server was restarted).
-				o_msg_response = new af::Msg( af::Msg::TRenderId, 0);
-			}
-			else if ( render->isOffline())
-			{
-				// The server has not received any registration message from
-				// this render, but it is nevertheless running. The conclusion
-				// to reach is that the render was still running while the
-				// server have been restarted (maybe because it crashed).
-				// We ask the render to send a list of the tasks it is in charge
-				// of to reconnect it. It should then send a TRenderReconnect.
-				o_msg_response = new af::Msg( af::Msg::TRenderId, 0);
-			}
-			else
-			{
-				o_msg_response = render->update( *rup);
-				render_found = true;
-			}
-		}
+		// Render update is answered without containers locks,
+		// so it does not wait for the run cycle.
+		o_msg_response = RenderHeartbeats::Update( *rup, render_found);
 
 		if( render_found)
 		{
-			// Task outputs received:
-			if( rup->m_outputs.size())
-			{
-				AfContainerLock mlock( i_args->monitors, AfContainerLock::WRITELOCK);
-
-				i_args->monitors->outputsReceived( rup->m_outspos, rup->m_outputs);
-			}
-
-			// To update tasks (if any) we push message to run thread:
-			if( rup->m_taskups.size())
+			// To update tasks and send outputs (if any) we push message to run thread:
+			if( rup->m_taskups.size() || rup->m_outputs.size())
 			{
 				i_args->rupQueue->pushUp( rup);
+				RunCycle::Wake();
 				return o_msg_response;
 			}
 		}
@@ -9,6 +9,8 @@
 #include "jobcontainer.h"
 #include "monitorcontainer.h"
 #include "rendercontainer.h"
+#include "renderheartbeats.h"
+#include "runcycle.h"
 #include "socketsprocessing.h"
 #include "solver.h"
 #include "threadargs.h"
@@ -25,6 +27,9 @@ extern bool AFRunning;
 // Messages reaction case function
 void threadRunCycleCase( ThreadArgs * i_args, af::Msg * i_msg);
 
+// Store is saved by this period, cycles can follow with any frequency.
+static const int64_t StoreSavePeriodMSec = 100000;
+
 /** This is a main run cycle thread entry point
 **/
 void threadRunCycle( void * i_args)
@@ -38,11 +43,14 @@ void threadRunCycle( void * i_args)
 
 	// Save store to store start time:
 	AFCommon::saveStore();
+	int64_t store_saved = RunCycle::NowMSec();
 
-	long long cycle = 0;
+	bool woken = false;
 
 	while( AFRunning)
 	{
+	RunCycle::CycleStarted( woken);
+
 	#ifdef _DEBUG
 	printf("...................................\n");
 	#endif
@@ -50,8 +58,7 @@ void threadRunCycle( void * i_args)
 	//
 	// Free authentication clients store:
 	//
-	//if( cycle % 10 == 0 )
-		Auth::free();
+	Auth::free();
 
 	{
 	//
@@ -71,10 +78,8 @@ void threadRunCycle( void * i_args)
 	/*
 		Process all messages in our message queue. We do it without
 		waiting so that the job solving below can run just after.
-		NOTE: I think this should be a waiting operation in a different
-		thread. The job solving below should be put asleep using a
-		semaphore and woke up when something changes. We need to avoid
-		the Sleep() function below.
+		Run cycle is woken up by RunCycle::Wake() when something is
+		pushed to these queues, see waiting below.
 	*/
 
 	//
@@ -86,6 +91,10 @@ void threadRunCycle( void * i_args)
 		for( int i = 0; i < rup->m_taskups.size(); i++)
 			a->jobs->updateTaskState( *(rup->m_taskups[i]), a->renders, a->monitors);
 
+		// Task outputs received:
+		if( rup->m_outputs.size())
+			a->monitors->outputsReceived( rup->m_outspos, rup->m_outputs);
+
 		delete rup;
 	}
 
@@ -115,6 +124,13 @@ void threadRunCycle( void * i_args)
 	AFINFO("ThreadRun::run: dispatching monitor events:")
 	a->monitors->dispatch( a->renders);
 
+	//
+	// Publish renders events, they will be sent on renders updates,
+	// or at once to renders waiting for events:
+	//
+	a->renders->publishEvents();
+	RenderHeartbeats::CheckWaiting();
+
 	//
 	// Free Containers:
 	//
@@ -126,21 +142,22 @@ void threadRunCycle( void * i_args)
 
 	}// - lock containers
 
+	RunCycle::CycleFinished();
+
 	// Save store
-	if( cycle % 100 == 0 )
+	if( RunCycle::NowMSec() - store_saved >= StoreSavePeriodMSec )
 	{
 		// Store should be save on change.
 		// But it can be also used to see some statistics.
 		AFCommon::saveStore();
+		store_saved = RunCycle::NowMSec();
 	}
 
 	//
-	// Sleeping
+	// Waiting for events or timers
 	//
-	AFINFO("ThreadRun::run: sleeping...")
-	   af::sleep_sec( 1);
-
-	cycle++;
+	AFINFO("ThreadRun::run: waiting...")
+	woken = RunCycle::Wait();
 	}// - while running
 
 	// Save store on exit:
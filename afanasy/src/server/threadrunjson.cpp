@@ -10,7 +10,7 @@
 #undef AFOUTPUT
 #include "../include/macrooutput.h"
 
-af::Msg * threadRunJSON( ThreadArgs * i_args, const af::Msg * i_msg)
+af::Msg * threadRunJSON( ThreadArgs * i_args, af::Msg * i_msg)
 {
 	Action action( i_msg, i_args);
 	if( action.isInvalid())
@@ -18,7 +18,7 @@
 #undef AFOUTPUT
 #include "../include/macrooutput.h"
 
-af::Msg * threadRunJSON( ThreadArgs * i_args, const af::Msg * i_msg);
+af::Msg * threadRunJSON( ThreadArgs * i_args, af::Msg * i_msg);
 
 af::Msg * threadRunCycleCase( ThreadArgs * i_args, af::Msg * i_msg)
 {
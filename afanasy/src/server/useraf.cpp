@@ -21,21 +21,24 @@ UserContainer * UserAf::ms_users = NULL;
 
 UserAf::UserAf( const std::string & username, const std::string & host):
 	af::User( username, host),
-	AfNodeSolve( this)
+	AfNodeSolve( this),
+	m_solve_list_sorted( false)
 {
 	appendLog("Registered from job.");
 }
 
 UserAf::UserAf( JSON & i_object):
     af::User(),
-	AfNodeSolve( this)
+	AfNodeSolve( this),
+	m_solve_list_sorted( false)
 {
 	jsonRead( i_object);
 }
 
 UserAf::UserAf( const std::string & i_store_dir):
 	af::User(),
-	AfNodeSolve( this, i_store_dir)
+	AfNodeSolve( this, i_store_dir),
+	m_solve_list_sorted( false)
 {
 	int size;
 	char * data = af::fileRead( getStoreFile(), &size);
@@ -325,9 +328,9 @@ bool UserAf::v_canRun()
 bool UserAf::v_canRunOn( RenderAf * i_render)
 {
 // check hosts mask:
-	if( false == checkHostsMask( i_render->getName())) return false;
+	if( false == checkHostsMask( i_render->getName(), i_render->getNameMatches())) return false;
 // check exclude hosts mask:
-	if( false == checkHostsMaskExclude( i_render->getName())) return false;
+	if( false == checkHostsMaskExclude( i_render->getName(), i_render->getNameMatches())) return false;
 
 // Returning that user is able to run on specified render
 	return true;
@@ -342,9 +345,26 @@ RenderAf * UserAf::v_solve( std::list<RenderAf*> & i_renders_list, MonitorContai
 		solve_method = af::Work::SolveByPriority;
 	}
 
-	std::list<AfNodeSolve*> solve_list( m_jobslist.getStdList());
+	RenderAf * render = NULL;
+	if( Solver::IsIncremental())
+	{
+		// Jobs are sorted on the first user solve only,
+		// later only the solved job is repositioned.
+		if( false == m_solve_list_sorted )
+		{
+			m_solve_list = m_jobslist.getStdList();
+			Solver::SortList( m_solve_list, solve_method);
+			m_solve_list_sorted = true;
+		}
+
+		render = Solver::SolveSortedList( m_solve_list, i_renders_list, solve_method);
+	}
+	else
+	{
+		std::list<AfNodeSolve*> solve_list( m_jobslist.getStdList());
 
-	RenderAf * render = Solver::SolveList( solve_list, i_renders_list, solve_method);
+		render = Solver::SolveList( solve_list, i_renders_list, solve_method);
+	}
 
 	if( render )
 	{
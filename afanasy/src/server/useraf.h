@@ -66,6 +66,9 @@ public:
 
 	void logAction( const Action & i_action, const std::string & i_node_name);
 
+	/// Free jobs list sorted for incremental solving.
+	inline void solvingFinished() { m_solve_list.clear(); m_solve_list_sorted = false; }
+
 protected:
 	void v_calcNeed();
 
@@ -79,6 +82,10 @@ private:
 private:
 	AfList m_jobslist; ///< Jobs list.
 
+	/// Jobs sorted once per solve, when solving is incremental.
+	std::list<AfNodeSolve*> m_solve_list;
+	bool m_solve_list_sorted;
+
 private:
    static UserContainer * ms_users;
 };
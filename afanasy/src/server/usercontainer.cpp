@@ -5,6 +5,7 @@
 
 #include "../include/afanasy.h"
 #include "../libafanasy/msgqueue.h"
+#include "../libafanasy/msgstream.h"
 
 #include "../libafsql/dbconnection.h"
 
@@ -165,7 +166,7 @@ af::Msg * UserContainer::generateJobsList( const std::vector<int32_t> & ids, con
 {
 	UserContainerIt usersIt( this);
 	MCAfNodes mcjobs;
-	std::ostringstream stream;
+	af::MsgStream stream;
 	bool has_jobs = false;
 
 	if( i_json )
@@ -195,7 +196,7 @@ af::Msg * UserContainer::generateJobsList( const std::vector<int32_t> & ids, con
 	if( i_json )
 	{
 		stream << "\n]}";
-		return af::jsonMsg( stream);
+		return stream.generateMsg();
 	}
 
 	af::Msg * msg = new af::Msg();